@@ -0,0 +1,85 @@
+// MyMap on its default red-black tree against MyMap on a MyBTree with a few
+// node sizes, uint64 -> uint64: inserts of shuffled keys into an empty map,
+// lookups of present keys in random order, and one ordered scan over the
+// whole map, in ns per element.
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DMYSTL_BUILD_BENCHMARKS=ON
+//   cmake --build build && ./build/mystl_bench_btree
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "my_map.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+using key_type = std::uint64_t;
+
+template <std::size_t NodeBytes>
+using btree_map = mystl::MyMap<key_type, std::uint64_t, mystl::less<key_type>,
+                               mystl::MyAllocator<mystl::pair<const key_type, std::uint64_t>>,
+                               mystl::btree_backend<NodeBytes>>;
+
+volatile std::uint64_t sink = 0;
+
+template <typename F>
+double ns_per_op(std::size_t ops, F&& f){
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) /
+           static_cast<double>(ops);
+}
+
+template <typename Map>
+void run(const char* name, const std::vector<key_type>& keys, const std::vector<key_type>& probes){
+    using value_type = mystl::pair<const key_type, std::uint64_t>;
+    Map map;
+    double insert = ns_per_op(keys.size(), [&]{
+        for (key_type k : keys) map.insert(value_type(k, k));
+    });
+
+    double find = ns_per_op(probes.size(), [&]{
+        std::uint64_t sum = 0;
+        for (key_type k : probes) sum += map.find(k)->second;
+        sink = sink + sum;
+    });
+
+    double scan = ns_per_op(map.size(), [&]{
+        std::uint64_t sum = 0;
+        for (auto it = map.begin(); it != map.end(); ++it) sum += it->second;
+        sink = sink + sum;
+    });
+
+    std::printf("  %-16s %10.1f %10.1f %10.2f\n", name, insert, find, scan);
+}
+
+void run_all(std::size_t n){
+    std::mt19937_64 rng(n);
+    std::vector<key_type> keys(n);
+    for (std::size_t i = 0; i < n; ++i) keys[i] = i * 0x9E3779B97F4A7C15ULL;
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::vector<key_type> probes(keys);
+    std::shuffle(probes.begin(), probes.end(), rng);
+
+    std::printf("%zu keys\n  %-16s %10s %10s %10s\n", n, "tree", "insert", "find", "scan");
+    run<mystl::MyMap<key_type, std::uint64_t>>("rbtree", keys, probes);
+    run<btree_map<256>>("btree 256 B", keys, probes);
+    run<btree_map<512>>("btree 512 B", keys, probes);
+    run<btree_map<1024>>("btree 1024 B", keys, probes);
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(){
+    run_all(std::size_t(1) << 16);
+    run_all(std::size_t(1) << 20);
+    run_all(std::size_t(1) << 22);
+    return sink == 42 ? 1 : 0;
+}
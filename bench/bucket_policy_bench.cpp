@@ -0,0 +1,85 @@
+// Lookup latency of MyHashTable under each bucket index policy: plain
+// modulo, power-of-two mask, fastrange and prime with fastmod, in ns per op.
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DMYSTL_BUILD_BENCHMARKS=ON
+//   cmake --build build && ./build/mystl_bench_bucket_policy
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "my_hashtable.h"
+
+namespace {
+
+using key_type = std::uint64_t;
+using clock_type = std::chrono::steady_clock;
+
+template <typename Policy>
+using table_type = mystl::MyHashTable<key_type, key_type, std::hash<key_type>, mystl::equal_to<key_type>,
+                                      mystl::MyAllocator<mystl::hash_node<key_type, key_type>>, Policy>;
+
+volatile std::uint64_t sink = 0;
+
+template <typename F>
+double ns_per_op(std::size_t ops, F&& f){
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) /
+           static_cast<double>(ops);
+}
+
+template <typename Policy>
+void run(const char* name, const std::vector<key_type>& keys, const std::vector<key_type>& probes){
+    table_type<Policy> table(keys.size());
+    for (key_type k : keys) table.insert(k, k);
+
+    constexpr int rounds = 5;
+    double hit = ns_per_op(probes.size() * rounds, [&]{
+        std::uint64_t sum = 0;
+        for (int r = 0; r < rounds; ++r)
+            for (key_type k : probes) sum += *table.find(k);
+        sink = sink + sum;
+    });
+    std::printf("  %-10s buckets %8zu  load %.3f  hit %7.2f\n",
+                name, table.bucket_count(), static_cast<double>(table.load_factor()), hit);
+}
+
+void run_all(const std::vector<key_type>& keys){
+    // probe in a shuffled order so the walk does not follow insertion order
+    std::vector<key_type> probes(keys);
+    std::shuffle(probes.begin(), probes.end(), std::mt19937_64(7));
+
+    run<mystl::mod_bucket_policy>("mod", keys, probes);
+    run<mystl::pow2_bucket_policy>("pow2", keys, probes);
+    run<mystl::fastrange_bucket_policy>("fastrange", keys, probes);
+    run<mystl::prime_bucket_policy>("prime", keys, probes);
+}
+
+} // namespace
+
+int main(){
+    const std::size_t sizes[] = {1u << 10, 1u << 16, 1u << 20};
+    std::mt19937_64 rng(42);
+    std::printf("ns per successful lookup\n");
+
+    for (std::size_t n : sizes) {
+        std::vector<key_type> keys(n);
+
+        for (auto& k : keys) k = rng();
+        std::printf("%zu random keys\n", n);
+        run_all(keys);
+
+        // sequential keys stride the identity std::hash evenly, which flatters
+        // modulo and shows what mixing costs when the hash is already good
+        for (std::size_t i = 0; i < n; ++i) keys[i] = i;
+        std::printf("%zu sequential keys\n", n);
+        run_all(keys);
+    }
+    return sink == 42 ? 1 : 0;
+}
@@ -0,0 +1,88 @@
+// Loading a table from a range: one insert at a time, insert after a
+// reserve, and MyHashTable::build on one thread and on every hardware
+// thread, in ns per element. The input carries about 5% duplicate keys.
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DMYSTL_BUILD_BENCHMARKS=ON
+//   cmake --build build && ./build/mystl_bench_bulk_build
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "my_unordered_map.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+volatile std::uint64_t sink = 0;
+
+template <typename F>
+double ns_per_op(std::size_t ops, F&& f){
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) /
+           static_cast<double>(ops);
+}
+
+template <typename Key, typename Value>
+void run(const char* name, const std::vector<std::pair<Key, Value>>& input){
+    using map_type = mystl::MyUnorderedMap<Key, Value>;
+    std::size_t n = input.size();
+
+    double one_by_one = ns_per_op(n, [&]{
+        map_type map;
+        for (const auto& kv : input) map.insert(kv.first, kv.second);
+        sink = sink + map.size();
+    });
+
+    double reserved = ns_per_op(n, [&]{
+        map_type map;
+        map.reserve(n);
+        for (const auto& kv : input) map.insert(kv.first, kv.second);
+        sink = sink + map.size();
+    });
+
+    double build_one = ns_per_op(n, [&]{
+        map_type map;
+        map.build(input.begin(), input.end(), mystl::duplicate_policy::last_wins, 1);
+        sink = sink + map.size();
+    });
+
+    double build_all = ns_per_op(n, [&]{
+        map_type map;
+        map.build(input.begin(), input.end(), mystl::duplicate_policy::last_wins, 0);
+        sink = sink + map.size();
+    });
+
+    std::printf("%-18s %10zu %10.1f %10.1f %12.1f %12.1f\n", name, n, one_by_one, reserved,
+                build_one, build_all);
+}
+
+} // namespace
+
+int main(){
+    std::mt19937_64 rng(7);
+    const std::size_t n = 4000000;
+    const std::uint64_t key_range = n + n / 20;
+
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> ints(n);
+    for (std::size_t i = 0; i < n; ++i) ints[i] = {rng() % key_range * 0x9E3779B97F4A7C15ULL, i};
+
+    std::vector<std::pair<std::string, std::uint64_t>> strings(n / 4);
+    for (std::size_t i = 0; i < strings.size(); ++i)
+        strings[i] = {"ref/" + std::to_string(rng() % (key_range / 4)), i};
+
+    std::printf("%u hardware threads, ns per element\n", std::thread::hardware_concurrency());
+    std::printf("%-18s %10s %10s %10s %12s %12s\n", "keys", "elements", "insert", "reserve",
+                "build(1)", "build(all)");
+    run("uint64_t", ints);
+    run("std::string", strings);
+    return sink == 42 ? 1 : 0;
+}
@@ -0,0 +1,137 @@
+// Throughput of a MyUnorderedMap behind one global mutex against
+// MyConcurrentHashMap, from 1 to 64 threads, for a read-mostly mix
+// (95% find, 5% upsert) and a write-heavy one (50% upsert, 25% erase,
+// 25% find), in million ops per second over all threads.
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DMYSTL_BUILD_BENCHMARKS=ON
+//   cmake --build build && ./build/mystl_bench_concurrent_hash_map
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "my_concurrent_hash_map.h"
+#include "my_unordered_map.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+volatile std::uint64_t sink = 0;
+
+constexpr std::uint64_t key_space = 1u << 16;
+constexpr std::size_t ops_per_thread = 200000;
+
+// what the workers run today: every operation takes the one lock
+struct global_mutex_map{
+    std::mutex lock;
+    mystl::MyUnorderedMap<std::uint64_t, std::uint64_t> map;
+
+    bool find(std::uint64_t key, std::uint64_t& out){
+        std::lock_guard<std::mutex> guard(lock);
+        std::uint64_t* value = map.find(key);
+        if (!value) return false;
+        out = *value;
+        return true;
+    }
+
+    void upsert(std::uint64_t key){
+        std::lock_guard<std::mutex> guard(lock);
+        map.try_emplace(key, std::uint64_t{0}).first->second += 1;
+    }
+
+    void erase(std::uint64_t key){
+        std::lock_guard<std::mutex> guard(lock);
+        map.erase(key);
+    }
+};
+
+struct sharded_map{
+    mystl::MyConcurrentHashMap<std::uint64_t, std::uint64_t> map;
+
+    bool find(std::uint64_t key, std::uint64_t& out){return map.find(key, out);}
+
+    void upsert(std::uint64_t key){
+        map.upsert(key, [](std::uint64_t& v){ v += 1; }, 1u);
+    }
+
+    void erase(std::uint64_t key){map.erase(key);}
+};
+
+// xorshift64*, cheap enough not to hide the map
+std::uint64_t next_random(std::uint64_t& state){
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+// writes_pct of the ops upsert; half as many again erase when erasing
+template <typename Map>
+double run(unsigned threads, unsigned writes_pct, bool erasing){
+    Map map;
+    for (std::uint64_t k = 0; k < key_space; k += 2) map.upsert(k);
+
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    std::vector<std::uint64_t> sums(threads);
+
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]{
+            std::uint64_t state = 0x9E3779B97F4A7C15ULL * (t + 1);
+            std::uint64_t sum = 0;
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (std::size_t i = 0; i < ops_per_thread; ++i) {
+                std::uint64_t r = next_random(state);
+                std::uint64_t key = r % key_space;
+                unsigned roll = static_cast<unsigned>((r >> 32) % 100);
+                std::uint64_t value = 0;
+                if (roll < writes_pct) {
+                    map.upsert(key);
+                } else if (erasing && roll < writes_pct + writes_pct / 2) {
+                    map.erase(key);
+                } else if (map.find(key, value)) {
+                    sum += value;
+                }
+            }
+            sums[t] = sum;
+        });
+    }
+
+    while (ready.load() != threads) std::this_thread::yield();
+    auto start = clock_type::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& w : workers) w.join();
+    auto stop = clock_type::now();
+
+    for (std::uint64_t s : sums) sink = sink + s;
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    return static_cast<double>(ops_per_thread) * threads / seconds / 1e6;
+}
+
+void table(const char* name, unsigned writes_pct, bool erasing){
+    std::printf("%s\n%8s %14s %14s %8s\n", name, "threads", "global mutex", "sharded", "speedup");
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u, 64u}) {
+        double global = run<global_mutex_map>(threads, writes_pct, erasing);
+        double sharded = run<sharded_map>(threads, writes_pct, erasing);
+        std::printf("%8u %14.2f %14.2f %7.2fx\n", threads, global, sharded, sharded / global);
+    }
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(){
+    std::printf("%llu keys, %zu ops per thread, %u hardware threads, Mops/s\n\n",
+                static_cast<unsigned long long>(key_space), ops_per_thread,
+                std::thread::hardware_concurrency());
+    table("read-mostly (95% find, 5% upsert)", 5, false);
+    table("write-heavy (50% upsert, 25% erase, 25% find)", 50, true);
+    return sink == 42 ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+// Compare MyFlatHashMap against the chained MyHashTable at a range of load
+// factors: insert, successful lookup and unsuccessful lookup, in ns per op.
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DMYSTL_BUILD_BENCHMARKS=ON
+//   cmake --build build && ./build/mystl_bench_flat_hash_map
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "my_flat_hash_map.h"
+#include "my_hashtable.h"
+
+namespace {
+
+using key_type = std::uint64_t;
+using clock_type = std::chrono::steady_clock;
+
+volatile std::uint64_t sink = 0;
+
+template <typename F>
+double ns_per_op(std::size_t ops, F&& f){
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) /
+           static_cast<double>(ops);
+}
+
+struct result{
+    double load;
+    double insert;
+    double hit;
+    double miss;
+};
+
+template <typename Table>
+result run(Table& table, const std::vector<key_type>& keys, const std::vector<key_type>& misses){
+    result r{};
+    r.insert = ns_per_op(keys.size(), [&]{
+        for (key_type k : keys) table.insert(k, k);
+    });
+    r.hit = ns_per_op(keys.size(), [&]{
+        std::uint64_t sum = 0;
+        for (key_type k : keys) sum += *table.find(k);
+        sink = sink + sum;
+    });
+    r.miss = ns_per_op(misses.size(), [&]{
+        std::uint64_t found = 0;
+        for (key_type k : misses) found += table.find(k) != nullptr;
+        sink = sink + found;
+    });
+    r.load = static_cast<double>(table.load_factor());
+    return r;
+}
+
+void print(const char* name, const result& r){
+    std::printf("  %-8s load %.3f  insert %7.2f  hit %7.2f  miss %7.2f\n",
+                name, r.load, r.insert, r.hit, r.miss);
+}
+
+} // namespace
+
+int main(){
+    constexpr std::size_t capacity = (std::size_t(1) << 20) - 1;
+    const double loads[] = {0.5, 0.625, 0.75, 0.875};
+
+    std::mt19937_64 rng(42);
+    std::printf("ns per operation, %zu slots\n", capacity);
+
+    for (double load : loads) {
+        std::size_t n = static_cast<std::size_t>(load * static_cast<double>(capacity));
+        std::vector<key_type> keys(n), misses(n);
+        for (auto& k : keys) k = rng() | 1;      // odd keys are present
+        for (auto& k : misses) k = rng() & ~key_type(1);
+
+        std::printf("target load %.3f (%zu keys)\n", load, n);
+        {
+            mystl::MyFlatHashMap<key_type, key_type> flat(capacity);
+            print("flat", run(flat, keys, misses));
+        }
+        {
+            // the chained table rehashes above 0.75, so its real load is printed
+            mystl::MyHashTable<key_type, key_type> chained(static_cast<std::size_t>(static_cast<double>(n) / load));
+            print("chained", run(chained, keys, misses));
+        }
+    }
+    return sink == 42 ? 1 : 0;
+}
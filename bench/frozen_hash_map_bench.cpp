@@ -0,0 +1,76 @@
+// Cold start of a uint64 -> uint64 table: rebuilding a MyUnorderedMap
+// from the loaded pairs against opening a MyFrozenHashMap image file, in
+// ms, at growing sizes; then lookup latency of both in ns per op. The
+// image is written to the working directory and removed afterwards.
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DMYSTL_BUILD_BENCHMARKS=ON
+//   cmake --build build && ./build/mystl_bench_frozen_hash_map
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "my_frozen_hash_map.h"
+#include "my_unordered_map.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+using frozen_type = mystl::MyFrozenHashMap<std::uint64_t, std::uint64_t>;
+
+volatile std::uint64_t sink = 0;
+
+const char* const image_path = "mystl_frozen_bench.img";
+
+template <typename F>
+double ms_for(F&& f){
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+void run(std::size_t n){
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> pairs(n);
+    for (std::size_t i = 0; i < n; ++i) pairs[i] = {i * 0x9E3779B97F4A7C15ULL, i};
+
+    mystl::MyUnorderedMap<std::uint64_t, std::uint64_t> source;
+    source.build(pairs.begin(), pairs.end());
+    frozen_type::write_file(source, image_path);
+
+    mystl::MyUnorderedMap<std::uint64_t, std::uint64_t> rebuilt;
+    double rebuild = ms_for([&]{
+        for (const auto& kv : pairs) rebuilt.insert(kv.first, kv.second);
+    });
+
+    frozen_type frozen;
+    double open = ms_for([&]{
+        frozen = frozen_type::open(image_path);
+        sink = sink + *frozen.find(pairs[n / 2].first);
+    });
+
+    std::uint64_t sum = 0;
+    double map_lookup = ms_for([&]{
+        for (const auto& kv : pairs) sum += *rebuilt.find(kv.first);
+    }) * 1e6 / static_cast<double>(n);
+    double frozen_lookup = ms_for([&]{
+        for (const auto& kv : pairs) sum += *frozen.find(kv.first);
+    }) * 1e6 / static_cast<double>(n);
+    sink = sink + sum;
+
+    std::printf("%10zu %12.1f %12.3f %14.1f %14.1f\n", n, rebuild, open, map_lookup, frozen_lookup);
+    std::remove(image_path);
+}
+
+} // namespace
+
+int main(){
+    std::printf("%10s %12s %12s %14s %14s\n", "entries", "rebuild ms", "open ms", "map find ns",
+                "frozen find ns");
+    for (std::size_t n : {std::size_t(1) << 16, std::size_t(1) << 20, std::size_t(1) << 22,
+                          std::size_t(1) << 23})
+        run(n);
+    return sink == 42 ? 1 : 0;
+}
@@ -0,0 +1,89 @@
+// Plain insert against hinted insert on MyMap<uint64, uint64>, on the
+// red-black tree and on the B+ tree backend, in ns per element:
+//   - descending: keys arrive in reverse order, the hint is the previous
+//     key's position
+//   - interleave: a map of the even keys takes the odd ones in order, the
+//     hint is the position after the previous insert
+// Keys arriving in ascending order need no hint: plain inserts past the
+// largest key already skip the descent.
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DMYSTL_BUILD_BENCHMARKS=ON
+//   cmake --build build && ./build/mystl_bench_hinted_insert
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#include "my_map.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+using value_type = mystl::pair<const std::uint64_t, std::uint64_t>;
+
+volatile std::uint64_t sink = 0;
+
+template <typename F>
+double ns_per_op(std::size_t ops, F&& f){
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) /
+           static_cast<double>(ops);
+}
+
+template <typename Map>
+void run(const char* name, std::size_t n){
+    double descending = ns_per_op(n, [&]{
+        Map map;
+        for (std::size_t i = n; i-- > 0;) map.insert(value_type(i, i));
+        sink = sink + map.size();
+    });
+    double descending_hinted = ns_per_op(n, [&]{
+        Map map;
+        auto hint = map.end();
+        for (std::size_t i = n; i-- > 0;) hint = map.insert(hint, value_type(i, i));
+        sink = sink + map.size();
+    });
+
+    auto evens = [&]{
+        Map map;
+        auto hint = map.end();
+        for (std::size_t i = 0; i < n; i += 2) hint = map.insert(hint, value_type(i, i));
+        return map;
+    };
+    Map plain_map = evens();
+    double interleave = ns_per_op(n / 2, [&]{
+        for (std::size_t i = 1; i < n; i += 2) plain_map.insert(value_type(i, i));
+    });
+    Map hinted_map = evens();
+    double interleave_hinted = ns_per_op(n / 2, [&]{
+        auto hint = hinted_map.begin();
+        ++hint;
+        for (std::size_t i = 1; i < n; i += 2) {
+            hint = hinted_map.insert(hint, value_type(i, i));
+            ++hint;
+            ++hint;
+        }
+    });
+    sink = sink + plain_map.size() + hinted_map.size();
+
+    std::printf("  %-8s %12.1f %12.1f %12.1f %12.1f\n", name, descending, descending_hinted, interleave,
+                interleave_hinted);
+}
+
+void run_all(std::size_t n){
+    std::printf("%zu keys\n  %-8s %12s %12s %12s %12s\n", n, "tree", "descending", "hinted", "interleave",
+                "hinted");
+    run<mystl::MyMap<std::uint64_t, std::uint64_t>>("rbtree", n);
+    run<mystl::MyBTreeMap<std::uint64_t, std::uint64_t>>("btree", n);
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(){
+    run_all(std::size_t(1) << 16);
+    run_all(std::size_t(1) << 20);
+    return sink == 42 ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+// Memory per key and speed of MyUnorderedSet<uint32_t> (one hash_node per
+// key) against MyIntHashSet with linear probing and with Robin Hood
+// probing. Bytes per key are what the heap holds for the set, malloc
+// headers and size-class slack included (glibc only; elsewhere the slot
+// and node sizes are summed instead). Times are ns per op: inserts from
+// empty with all the growth on the way, then lookups of present keys and
+// of absent ones.
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DMYSTL_BUILD_BENCHMARKS=ON
+//   cmake --build build && ./build/mystl_bench_int_hash_set
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define BENCH_HAS_MALLINFO2 1
+#else
+#define BENCH_HAS_MALLINFO2 0
+#endif
+
+#include "my_int_hash_set.h"
+#include "my_unordered_set.h"
+
+namespace {
+
+using key_type = std::uint32_t;
+using clock_type = std::chrono::steady_clock;
+
+volatile std::uint64_t sink = 0;
+
+template <typename F>
+double ns_per_op(std::size_t ops, F&& f){
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) /
+           static_cast<double>(ops);
+}
+
+// bytes in use on the heap, or 0 when the C library cannot say
+std::size_t heap_in_use(){
+#if BENCH_HAS_MALLINFO2
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+std::size_t estimate_bytes(const mystl::MyUnorderedSet<key_type>& set){
+    return set.size() * sizeof(mystl::hash_node<key_type, key_type>) + set.bucket_count() * sizeof(void*);
+}
+
+template <typename Set>
+std::size_t estimate_bytes(const Set& set){
+    return set.bucket_count() * sizeof(key_type);
+}
+
+template <typename Set>
+void run(const char* name, const std::vector<key_type>& keys, const std::vector<key_type>& misses){
+    std::size_t before = heap_in_use();
+    double insert = 0;
+    double hit = 0;
+    double miss = 0;
+    double bytes = 0;
+    {
+        Set set;
+        insert = ns_per_op(keys.size(), [&]{
+            for (key_type k : keys) set.insert(k);
+        });
+        std::size_t used = heap_in_use() - before;
+        if (!used) used = estimate_bytes(set);
+        bytes = static_cast<double>(used) / static_cast<double>(set.size());
+
+        hit = ns_per_op(keys.size(), [&]{
+            std::uint64_t found = 0;
+            for (key_type k : keys) found += set.count(k);
+            sink = sink + found;
+        });
+        miss = ns_per_op(misses.size(), [&]{
+            std::uint64_t found = 0;
+            for (key_type k : misses) found += set.count(k);
+            sink = sink + found;
+        });
+        std::printf("  %-22s %10zu %8.3f %10.1f %8.1f %8.1f %8.1f\n", name, set.bucket_count(),
+                    static_cast<double>(set.load_factor()), bytes, insert, hit, miss);
+    }
+}
+
+void run_all(std::size_t n){
+    // i * odd constant is a bijection on 32 bits: distinct keys in
+    // scattered order, and the next n of them are guaranteed misses
+    std::vector<key_type> keys(n);
+    std::vector<key_type> misses(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<key_type>(i * 0x9E3779B1u);
+        misses[i] = static_cast<key_type>((i + n) * 0x9E3779B1u);
+    }
+
+    std::printf("%zu keys\n  %-22s %10s %8s %10s %8s %8s %8s\n", n, "set", "buckets", "load",
+                "bytes/key", "insert", "hit", "miss");
+    run<mystl::MyUnorderedSet<key_type>>("MyUnorderedSet", keys, misses);
+    run<mystl::MyIntHashSet<key_type>>("MyIntHashSet", keys, misses);
+    run<mystl::MyRobinHoodIntSet<key_type>>("MyRobinHoodIntSet", keys, misses);
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(){
+    std::printf("sizeof(hash_node<uint32_t, uint32_t>) = %zu, int set slot = %zu bytes%s\n\n",
+                sizeof(mystl::hash_node<key_type, key_type>), sizeof(key_type),
+                BENCH_HAS_MALLINFO2 ? "" : " (bytes/key estimated, no mallinfo2)");
+    // 6M fits both int sets at 2^23 slots; 7M is past the linear probing
+    // limit of 0.75 but still under the Robin Hood one of 0.875
+    run_all(std::size_t(1) << 20);
+    run_all(6000000);
+    run_all(7000000);
+    return sink == 42 ? 1 : 0;
+}
@@ -0,0 +1,90 @@
+// Insert/erase churn on MyUnorderedMap with the default MyAllocator against
+// MyPooledUnorderedMap (MyNodePool), then lookups over the churned table,
+// in ns per op.
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DMYSTL_BUILD_BENCHMARKS=ON
+//   cmake --build build && ./build/mystl_bench_node_pool
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "my_unordered_map.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+volatile std::uint64_t sink = 0;
+
+template <typename F>
+double ns_per_op(std::size_t ops, F&& f){
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) /
+           static_cast<double>(ops);
+}
+
+// keep `live` keys in the map; each churn step erases one at random and
+// inserts a key that is not present in its place
+template <typename Map, typename Key>
+void run(const char* name, const std::vector<Key>& keys, std::size_t live, std::size_t steps){
+    std::mt19937_64 rng(1);
+    Map map;
+    std::vector<std::size_t> slots(live);
+    for (std::size_t i = 0; i < live; ++i) {
+        slots[i] = i;
+        map.insert(keys[i], i);
+    }
+
+    std::size_t next = live;
+    double churn = ns_per_op(steps, [&]{
+        for (std::size_t s = 0; s < steps; ++s) {
+            std::size_t victim = static_cast<std::size_t>(rng() % live);
+            map.erase(keys[slots[victim]]);
+            // a long-lived key can still be present when its id comes round
+            do {
+                slots[victim] = next++ % keys.size();
+            } while (map.find(keys[slots[victim]]));
+            map.insert(keys[slots[victim]], s);
+        }
+    });
+
+    double lookup = ns_per_op(live, [&]{
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < live; ++i) sum += *map.find(keys[slots[i]]);
+        sink = sink + sum;
+    });
+    std::printf("  %-8s churn %7.2f  lookup %7.2f\n", name, churn, lookup);
+}
+
+template <typename Key>
+void run_both(const char* title, const std::vector<Key>& keys, std::size_t live, std::size_t steps){
+    std::printf("%s, %zu live keys, %zu churn steps\n", title, live, steps);
+    run<mystl::MyUnorderedMap<Key, std::size_t>>("malloc", keys, live, steps);
+    run<mystl::MyPooledUnorderedMap<Key, std::size_t>>("pool", keys, live, steps);
+}
+
+} // namespace
+
+int main(){
+    constexpr std::size_t live = 1u << 18;
+    constexpr std::size_t steps = 1u << 22;
+    // key ids cycle through four times the live set, so erased keys come back
+    constexpr std::size_t universe = live * 4;
+
+    std::mt19937_64 rng(42);
+    std::vector<std::uint64_t> ints(universe);
+    for (auto& k : ints) k = rng();
+    run_both("uint64 keys", ints, live, steps);
+
+    std::vector<std::string> strings(universe);
+    for (std::size_t i = 0; i < universe; ++i) strings[i] = "key:" + std::to_string(rng());
+    run_both("string keys", strings, live, steps);
+
+    return sink == 42 ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+// Range queries on a 1M-key MySet: counting the keys in random [a, b)
+// windows of growing width with count_range, on the plain red-black tree
+// (a walk over the range), the ranked one (two rank descents) and the
+// B+ tree (whole leaves at a time), in ns per query. Also the cost the
+// subtree sizes add to building the set one insert at a time.
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DMYSTL_BUILD_BENCHMARKS=ON
+//   cmake --build build && ./build/mystl_bench_range_query
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "my_set.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+volatile std::uint64_t sink = 0;
+
+template <typename F>
+double ns_per_op(std::size_t ops, F&& f){
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) /
+           static_cast<double>(ops);
+}
+
+template <typename Set>
+double build(Set& set, const std::vector<std::uint64_t>& keys){
+    return ns_per_op(keys.size(), [&]{
+        for (std::uint64_t k : keys) set.insert(k);
+    });
+}
+
+template <typename Set>
+double count_windows(Set& set, const std::vector<std::uint64_t>& lows, std::uint64_t width){
+    std::uint64_t total = 0;
+    double ns = ns_per_op(lows.size(), [&]{
+        for (std::uint64_t low : lows) total += set.count_range(low, low + width);
+    });
+    sink = sink + total;
+    return ns;
+}
+
+} // namespace
+
+int main(){
+    const std::size_t n = 1000000;
+    const std::uint64_t key_range = 4 * n;
+    std::mt19937_64 rng(11);
+
+    std::vector<std::uint64_t> keys(n);
+    for (auto& k : keys) k = rng() % key_range;
+
+    mystl::MySet<std::uint64_t> plain;
+    mystl::MyRankedSet<std::uint64_t> ranked;
+    mystl::MyBTreeSet<std::uint64_t> btree;
+    double plain_build = build(plain, keys);
+    double ranked_build = build(ranked, keys);
+    double btree_build = build(btree, keys);
+    std::printf("insert ns: rbtree %.1f, ranked rbtree %.1f, btree %.1f\n\n", plain_build,
+                ranked_build, btree_build);
+
+    std::printf("%10s %12s %12s %12s\n", "width", "rbtree", "ranked", "btree");
+    for (std::uint64_t width : {std::uint64_t(16), std::uint64_t(1) << 10, std::uint64_t(1) << 16,
+                                std::uint64_t(1) << 20}) {
+        std::size_t queries = width > 4096 ? 2000 : 200000;
+        std::vector<std::uint64_t> lows(queries);
+        for (auto& low : lows) low = rng() % key_range;
+        std::printf("%10llu %12.1f %12.1f %12.1f\n", static_cast<unsigned long long>(width),
+                    count_windows(plain, lows, width), count_windows(ranked, lows, width),
+                    count_windows(btree, lows, width));
+    }
+    return sink == 42 ? 1 : 0;
+}
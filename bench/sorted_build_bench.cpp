@@ -0,0 +1,77 @@
+// Building a uint64 -> uint64 MyMap from keys that are already sorted: one
+// insert per key against the sorted range constructor, and appending a
+// second sorted batch past the largest key with insert_sorted, on the
+// red-black tree and on the B+ tree backend, in ns per element.
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DMYSTL_BUILD_BENCHMARKS=ON
+//   cmake --build build && ./build/mystl_bench_sorted_build
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "my_map.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+using value_type = mystl::pair<const std::uint64_t, std::uint64_t>;
+
+volatile std::uint64_t sink = 0;
+
+template <typename F>
+double ns_per_op(std::size_t ops, F&& f){
+    auto start = clock_type::now();
+    f();
+    auto stop = clock_type::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) /
+           static_cast<double>(ops);
+}
+
+template <typename Map>
+void run(const char* name, const std::vector<value_type>& first_half, const std::vector<value_type>& second_half){
+    std::size_t n = first_half.size();
+
+    double one_by_one = ns_per_op(n, [&]{
+        Map map;
+        for (const auto& kv : first_half) map.insert(kv);
+        sink = sink + map.size();
+    });
+
+    double ranged = ns_per_op(n, [&]{
+        Map map(first_half.begin(), first_half.end());
+        sink = sink + map.size();
+    });
+
+    Map map(first_half.begin(), first_half.end());
+    double append = ns_per_op(second_half.size(), [&]{
+        map.insert_sorted(second_half.begin(), second_half.end());
+    });
+    sink = sink + map.size();
+
+    std::printf("  %-10s %12.1f %12.1f %12.1f\n", name, one_by_one, ranged, append);
+}
+
+void run_all(std::size_t n){
+    std::vector<value_type> first_half;
+    std::vector<value_type> second_half;
+    first_half.reserve(n);
+    second_half.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) first_half.emplace_back(i * 3, i);
+    for (std::size_t i = 0; i < n; ++i) second_half.emplace_back((n + i) * 3, i);
+
+    std::printf("%zu keys\n  %-10s %12s %12s %12s\n", n, "tree", "insert", "range ctor", "append");
+    run<mystl::MyMap<std::uint64_t, std::uint64_t>>("rbtree", first_half, second_half);
+    run<mystl::MyBTreeMap<std::uint64_t, std::uint64_t>>("btree", first_half, second_half);
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(){
+    run_all(std::size_t(1) << 16);
+    run_all(std::size_t(1) << 20);
+    run_all(std::size_t(1) << 22);
+    return sink == 42 ? 1 : 0;
+}
@@ -0,0 +1,73 @@
+// Short-lived ordered maps: build a MyMap<uint64_t, uint64_t> from random
+// keys, then destroy it, as a per-request map would be. MyMap on
+// MyAllocator against MyPooledMap, whose nodes come from MyNodePool blocks
+// that the destructor frees whole. In ns per element, at several sizes.
+//
+//   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DMYSTL_BUILD_BENCHMARKS=ON
+//   cmake --build build && ./build/mystl_bench_tree_arena
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "my_map.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+volatile std::uint64_t sink = 0;
+
+double ns_between(clock_type::time_point start, clock_type::time_point stop, std::size_t ops){
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) /
+           static_cast<double>(ops);
+}
+
+struct result{
+    double build;
+    double destroy;
+};
+
+// rounds maps of n keys each, built one after the other
+template <typename Map>
+result run(const std::vector<std::uint64_t>& keys, std::size_t n){
+    std::size_t rounds = keys.size() / n;
+    clock_type::duration build{0}, destroy{0};
+    for (std::size_t r = 0; r < rounds; ++r) {
+        auto start = clock_type::now();
+        auto map = std::make_unique<Map>();
+        for (std::size_t i = r * n; i < (r + 1) * n; ++i)
+            map->insert(mystl::pair<const std::uint64_t, std::uint64_t>(keys[i], i));
+        sink = sink + map->size();
+        auto built = clock_type::now();
+        map.reset();
+        auto stop = clock_type::now();
+        build += built - start;
+        destroy += stop - built;
+    }
+    std::size_t ops = rounds * n;
+    return {ns_between(clock_type::time_point(), clock_type::time_point(build), ops),
+            ns_between(clock_type::time_point(), clock_type::time_point(destroy), ops)};
+}
+
+} // namespace
+
+int main(){
+    const std::size_t total = 2000000;
+    std::mt19937_64 rng(3);
+    std::vector<std::uint64_t> keys(total);
+    for (auto& k : keys) k = rng();
+
+    std::printf("%10s %14s %14s %14s %14s\n", "keys/map", "build", "pooled build", "destroy",
+                "pooled destroy");
+    for (std::size_t n : {std::size_t(64), std::size_t(1024), std::size_t(65536), std::size_t(1) << 20}) {
+        result plain = run<mystl::MyMap<std::uint64_t, std::uint64_t>>(keys, n);
+        result pooled = run<mystl::MyPooledMap<std::uint64_t, std::uint64_t>>(keys, n);
+        std::printf("%10zu %14.1f %14.1f %14.1f %14.1f\n", n, plain.build, pooled.build,
+                    plain.destroy, pooled.destroy);
+    }
+    return sink == 42 ? 1 : 0;
+}
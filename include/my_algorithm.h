@@ -51,6 +51,20 @@ void reverse(BidirectionalIt first, BidirectionalIt last){
     }
 }
 
+// =============== rotate ===============
+// make middle the new first element, return where the old first ended up
+template <typename BidirectionalIt>
+BidirectionalIt rotate(BidirectionalIt first, BidirectionalIt middle, BidirectionalIt last){
+    if(first == middle) return last;
+    if(middle == last) return first;
+    mystl::reverse(first, middle);
+    mystl::reverse(middle, last);
+    mystl::reverse(first, last);
+    BidirectionalIt result = first;
+    for(BidirectionalIt it = middle; it != last; ++it) ++result;
+    return result;
+}
+
 // =============== min/max ==============
 template <typename T, typename Compare>
 const T& min(const T& a, const T& b, Compare comp){
@@ -100,6 +114,23 @@ BidirectionalIt2 copy_backward(BidirectionalIt1 first, BidirectionalIt1 last, Bi
     return d_last;
 }
 
+// =============== move / move backward =====================
+template <typename InputIt, typename OutputIt>
+OutputIt move(InputIt first, InputIt last, OutputIt result){
+    for(; first != last; ++first, ++result){
+        *result = mystl::move(*first);
+    }
+    return result;
+}
+
+template <typename BidirectionalIt1, typename BidirectionalIt2>
+BidirectionalIt2 move_backward(BidirectionalIt1 first, BidirectionalIt1 last, BidirectionalIt2 d_last){
+    while (first != last) {
+        *--d_last = mystl::move(*--last);
+    }
+    return d_last;
+}
+
 
 // ============== sort (quick sort impl) ===============
 template <typename RandomIt>
@@ -3,9 +3,44 @@
 
 // include necessary headers
 #include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "mystl_config.h"
+
+#if MYSTL_HAS_MALLOC_USABLE_SIZE
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+#endif
 
 namespace mystl{
 
+// what allocate_at_least hands back: the block and how many objects fit in it
+template <class Pointer, class SizeType = std::size_t>
+struct allocation_result {
+    Pointer ptr;
+    SizeType count;
+};
+
+// bytes the C allocator actually reserved for p (at least the requested
+// size); just the requested size unless MYSTL_HAS_MALLOC_USABLE_SIZE is on
+inline std::size_t usable_size(void* p, std::size_t requested) noexcept {
+#if MYSTL_HAS_MALLOC_USABLE_SIZE && defined(__APPLE__)
+    return p ? malloc_size(p) : requested;
+#elif MYSTL_HAS_MALLOC_USABLE_SIZE && defined(_WIN32)
+    return p ? _msize(p) : requested;
+#elif MYSTL_HAS_MALLOC_USABLE_SIZE
+    return p ? malloc_usable_size(p) : requested;
+#else
+    (void)p;
+    return requested;
+#endif
+}
+
 template <class T>
 class MyAllocator {
 public:
@@ -23,13 +58,22 @@ public:
     template <class U>
     MyAllocator(const MyAllocator<U>&) noexcept {}
 
+    // blocks come from malloc so their real size can be queried
     static pointer allocate(size_type n) {
-        return static_cast<pointer>(operator new(n * sizeof(value_type)));
+        return static_cast<pointer>(allocate_bytes(n));
+    }
+
+    // like allocate(n), but also report how many objects the block really
+    // holds; that is n unless MYSTL_HAS_MALLOC_USABLE_SIZE is on
+    static allocation_result<pointer, size_type> allocate_at_least(size_type n) {
+        void* p = allocate_bytes(n);
+        size_type count = usable_size(p, n * sizeof(value_type)) / sizeof(value_type);
+        return {static_cast<pointer>(p), count < n ? n : count};
     }
 
     // Deallocate
     static void deallocate(pointer p, size_type) noexcept{
-        ::operator delete(p);
+        std::free(p);
     }
 
     //construct
@@ -42,8 +86,42 @@ public:
     static void destroy(pointer p) noexcept {
         p->~T();
     }
+
+private:
+    static void* allocate_bytes(size_type n) {
+        if (n > static_cast<size_type>(-1) / sizeof(value_type)) {
+            throw std::bad_alloc();
+        }
+        // malloc(0) may return nullptr, which is not a valid block here
+        void* p = std::malloc(n == 0 ? 1 : n * sizeof(value_type));
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
 };
 
+// ask alloc for room for at least n objects. Allocators with an
+// allocate_at_least member can hand back more; others get exactly n
+template <class Alloc, class = void>
+struct has_allocate_at_least : std::false_type {};
+
+template <class Alloc>
+struct has_allocate_at_least<Alloc,
+    std::void_t<decltype(std::declval<Alloc&>().allocate_at_least(std::size_t(1)))>>
+    : std::true_type {};
+
+template <class Alloc>
+allocation_result<typename Alloc::value_type*, std::size_t>
+allocate_at_least(Alloc& alloc, std::size_t n) {
+    if constexpr (has_allocate_at_least<Alloc>::value) {
+        auto result = alloc.allocate_at_least(n);
+        return {result.ptr, static_cast<std::size_t>(result.count)};
+    } else {
+        return {alloc.allocate(n), n};
+    }
+}
+
 // Allocators for different types are equal
 template <class T, class U>
 bool operator==(const MyAllocator<T>&, const MyAllocator<U>& ) noexcept {
@@ -0,0 +1,1054 @@
+#ifndef MY_BTREE_H
+#define MY_BTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "my_allocator.h"
+#include "my_iterator.h"
+#include "my_utility.h"
+
+namespace mystl {
+
+// B+ tree backend for the ordered containers, an alternative to MyRBTree
+// with the same interface:
+//   - every node is one block of about NodeBytes bytes (default 512, eight
+//     cache lines). Leaves hold the elements side by side and are chained
+//     in key order, so an ordered scan reads whole blocks rather than one
+//     heap node per element
+//   - inner nodes keep their separator keys in one contiguous array next to
+//     the child pointers. Searches halve the array branch-free and finish
+//     with a linear count over a short window, which compilers vectorize
+//     for scalar keys
+//   - insert and erase split, borrow and merge nodes bottom-up through
+//     parent links. Inserting past the largest key leaves the split leaf
+//     full, so keys inserted in order pack the leaves completely
+// Unlike MyRBTree, insert and erase move elements between slots and so
+// invalidate every iterator and reference into the tree. Element moves are
+// assumed not to throw.
+
+inline constexpr std::size_t btree_default_node_bytes = 512;
+
+namespace detail {
+
+// uninitialised room for N objects of T, built and destroyed one by one
+template <typename T, std::size_t N>
+struct btree_slots {
+    alignas(T) unsigned char bytes[sizeof(T) * N];
+
+    T* data() noexcept {return std::launder(reinterpret_cast<T*>(bytes));}
+    const T* data() const noexcept {return std::launder(reinterpret_cast<const T*>(bytes));}
+};
+
+// move *src into the raw slot dst and end the lifetime of *src. Map
+// elements are pair<const Key, T>: their key is moved out through a
+// const_cast, which is fine because the source is destroyed right after
+template <typename T>
+struct btree_relocate {
+    static void apply(T* dst, T* src) noexcept {
+        ::new (static_cast<void*>(dst)) T(std::move(*src));
+        src->~T();
+    }
+};
+
+template <typename K, typename V>
+struct btree_relocate<mystl::pair<const K, V>> {
+    using slot_type = mystl::pair<const K, V>;
+
+    static void apply(slot_type* dst, slot_type* src) noexcept {
+        ::new (static_cast<void*>(dst)) slot_type(std::move(const_cast<K&>(src->first)), std::move(src->second));
+        src->~slot_type();
+    }
+};
+
+template <typename K, typename V>
+struct btree_relocate<std::pair<const K, V>> {
+    using slot_type = std::pair<const K, V>;
+
+    static void apply(slot_type* dst, slot_type* src) noexcept {
+        ::new (static_cast<void*>(dst)) slot_type(std::move(const_cast<K&>(src->first)), std::move(src->second));
+        src->~slot_type();
+    }
+};
+
+// entries of per_entry bytes that fit in a node of node_bytes after its
+// header; at least 4, so splits and merges always have room to work with,
+// and few enough for a 16-bit count
+constexpr std::size_t btree_fit(std::size_t node_bytes, std::size_t header, std::size_t per_entry) {
+    std::size_t n = node_bytes > header + 4 * per_entry ? (node_bytes - header) / per_entry : 4;
+    return n < 0xFFFE ? n : 0xFFFE;
+}
+
+// relocate n objects from src to dst; the ranges may overlap
+template <typename T>
+void btree_move_slots(T* dst, T* src, std::size_t n) noexcept {
+    if (std::less<T*>()(dst, src)) {
+        for (std::size_t i = 0; i < n; ++i) btree_relocate<T>::apply(dst + i, src + i);
+    } else {
+        for (std::size_t i = n; i-- > 0;) btree_relocate<T>::apply(dst + i, src + i);
+    }
+}
+
+// index of the first of the n entries for which before(entry) is false;
+// before must hold on a prefix of the entries. The halving steps compile
+// to conditional moves, and the last Window entries are counted linearly
+template <std::size_t Window, typename T, typename Pred>
+std::size_t btree_search(const T* first, std::size_t n, Pred before) {
+    const T* base = first;
+    while (n > Window) {
+        std::size_t half = n / 2;
+        base = before(base[half]) ? base + half : base;
+        n -= half;
+    }
+    std::size_t index = static_cast<std::size_t>(base - first);
+    for (std::size_t i = 0; i < n; ++i) index += static_cast<std::size_t>(before(base[i]));
+    return index;
+}
+
+} // namespace detail
+
+// =====================
+// btree iterator
+// =====================
+// (leaf, index) pair; past-the-end is one past the last element of the
+// rightmost leaf, and (nullptr, 0) in an empty tree
+template <typename Tree, typename Value>
+class btree_iterator{
+public:
+    using iterator_category = mystl::bidirectional_iterator_tag;
+    using value_type = typename std::remove_const<Value>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+private:
+    using leaf_node = typename Tree::leaf_node;
+    using size_type = typename Tree::size_type;
+
+    template <typename, typename> friend class btree_iterator;
+    friend Tree;
+
+    leaf_node* node_{nullptr};
+    size_type index_{0};
+
+public:
+    btree_iterator() = default;
+
+    btree_iterator(leaf_node* node, size_type index) : node_(node), index_(index) {}
+
+    // iterator -> const_iterator
+    template <typename V, typename = std::enable_if_t<std::is_same<const V, Value>::value &&
+                                                      !std::is_same<V, Value>::value>>
+    btree_iterator(const btree_iterator<Tree, V>& other) : node_(other.node_), index_(other.index_) {}
+
+    reference operator*() const {return node_->values()[index_];}
+    pointer operator->() const {return node_->values() + index_;}
+
+    btree_iterator& operator++(){
+        if(++index_ == node_->count && node_->next){
+            node_ = node_->next;
+            index_ = 0;
+        }
+        return *this;
+    }
+
+    btree_iterator operator++(int){
+        btree_iterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    btree_iterator& operator--(){
+        if(index_ == 0){
+            node_ = node_->prev;
+            index_ = node_->count;
+        }
+        --index_;
+        return *this;
+    }
+
+    btree_iterator operator--(int){
+        btree_iterator tmp = *this;
+        --(*this);
+        return tmp;
+    }
+
+    bool operator==(const btree_iterator& other) const noexcept {
+        return node_ == other.node_ && index_ == other.index_;
+    }
+
+    bool operator!=(const btree_iterator& other) const noexcept {return !(*this == other);}
+};
+
+
+// =====================
+// btree
+// =====================
+// Alloc is rebound to the leaf and inner node types, so the containers'
+// default node allocators work unchanged.
+template <typename Key, typename Value, typename KeyOfValue, typename Compare,
+          typename Alloc = mystl::MyAllocator<Value>,
+          std::size_t NodeBytes = btree_default_node_bytes>
+class MyBTree
+{
+public:
+    using key_type = Key;
+    using value_type = Value;
+    using size_type = std::size_t;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using reference = Value&;
+    using const_reference = const Value&;
+
+    using iterator = btree_iterator<MyBTree, Value>;
+    using const_iterator = btree_iterator<MyBTree, const Value>;
+
+private:
+    template <typename, typename> friend class btree_iterator;
+
+    using count_type = std::uint16_t;
+
+    struct inner_node;
+
+    struct node_base{
+        inner_node* parent;
+        count_type position;    // index in parent->children
+        count_type count;       // elements of a leaf, keys of an inner node
+        bool leaf;
+    };
+
+public:
+    static constexpr size_type node_bytes = NodeBytes;
+    static constexpr size_type leaf_capacity =
+        detail::btree_fit(NodeBytes, sizeof(node_base) + 2 * sizeof(void*), sizeof(Value));
+    static constexpr size_type inner_capacity =
+        detail::btree_fit(NodeBytes, sizeof(node_base) + sizeof(void*), sizeof(Key) + sizeof(void*));
+
+private:
+    static constexpr size_type leaf_min = leaf_capacity / 2;
+    static constexpr size_type inner_min = inner_capacity / 2;
+
+    // scalar keys are cheap to compare in bulk; anything else is searched
+    // by halving all the way down
+    static constexpr size_type search_window = std::is_scalar<Key>::value ? 8 : 1;
+
+    struct leaf_node : node_base{
+        leaf_node* prev;
+        leaf_node* next;
+        detail::btree_slots<Value, leaf_capacity> slots;
+
+        Value* values() noexcept {return slots.data();}
+    };
+
+    struct inner_node : node_base{
+        detail::btree_slots<Key, inner_capacity> key_slots;
+        node_base* children[inner_capacity + 1];
+
+        Key* keys() noexcept {return key_slots.data();}
+    };
+
+    using leaf_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<leaf_node>;
+    using inner_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<inner_node>;
+
+    struct slot_pos{
+        leaf_node* leaf;
+        size_type index;
+    };
+
+    node_base* root_{nullptr};
+    leaf_node* leftmost_{nullptr};
+    leaf_node* rightmost_{nullptr};
+    size_type size_{0};
+    Compare comp_;
+    leaf_allocator leaf_alloc_;
+    inner_allocator inner_alloc_;
+
+public:
+    MyBTree() : comp_(Compare()) {}
+
+    explicit MyBTree(const Compare& comp) : comp_(comp) {}
+
+    MyBTree(const MyBTree&) = delete;
+    MyBTree& operator=(const MyBTree&) = delete;
+
+    MyBTree(MyBTree&& other) noexcept
+        : root_(other.root_), leftmost_(other.leftmost_), rightmost_(other.rightmost_),
+          size_(other.size_), comp_(std::move(other.comp_)) {
+        other.root_ = nullptr;
+        other.leftmost_ = other.rightmost_ = nullptr;
+        other.size_ = 0;
+    }
+
+    MyBTree& operator=(MyBTree&& other) noexcept {
+        if(this != &other){
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~MyBTree() {clear();}
+
+    void swap(MyBTree& other) noexcept {
+        std::swap(root_, other.root_);
+        std::swap(leftmost_, other.leftmost_);
+        std::swap(rightmost_, other.rightmost_);
+        std::swap(size_, other.size_);
+        std::swap(comp_, other.comp_);
+    }
+
+    bool empty() const noexcept {return size_ == 0;}
+
+    size_type size() const noexcept {return size_;}
+
+    iterator begin() noexcept {return iterator(leftmost_, 0);}
+    iterator end() noexcept {return root_ ? iterator(rightmost_, rightmost_->count) : iterator();}
+
+    const_iterator begin() const noexcept {return const_iterator(leftmost_, 0);}
+    const_iterator end() const noexcept {
+        return root_ ? const_iterator(rightmost_, rightmost_->count) : const_iterator();
+    }
+
+    void clear(){
+        if(root_){
+            destroy_subtree(root_);
+        }
+        root_ = nullptr;
+        leftmost_ = rightmost_ = nullptr;
+        size_ = 0;
+    }
+
+    // insert after any elements with an equal key
+    iterator insert_equal(const value_type& v){
+        if(!root_){
+            return insert_first(v);
+        }
+        const Key& key = KeyOfValue()(v);
+        // keys arriving in order go straight to the end of the last leaf
+        if(!comp_(key, KeyOfValue()(rightmost_->values()[rightmost_->count - 1]))){
+            return insert_at(rightmost_, rightmost_->count, v);
+        }
+        slot_pos at = descend<true>(key);
+        return insert_at(at.leaf, at.index, v);
+    }
+
+    // insert v unless its key is already in the tree; the bool says which
+    mystl::pair<iterator, bool> insert_unique(const value_type& v){
+        if(!root_){
+            return {insert_first(v), true};
+        }
+        const Key& key = KeyOfValue()(v);
+        if(comp_(KeyOfValue()(rightmost_->values()[rightmost_->count - 1]), key)){
+            return {insert_at(rightmost_, rightmost_->count, v), true};
+        }
+        slot_pos at = descend<false>(key);
+        slot_pos hit = at.index == at.leaf->count ? slot_pos{at.leaf->next, 0} : at;
+        if(hit.leaf && !comp_(key, KeyOfValue()(hit.leaf->values()[hit.index]))){
+            return {iterator(hit.leaf, hit.index), false};
+        }
+        return {insert_at(at.leaf, at.index, v), true};
+    }
+
+    // insert_unique with a hint: the element v's key would come right
+    // before (end() for the largest). When v fits between the hint and its
+    // predecessor in the same leaf, or in front of the first element, it
+    // goes in there without a descent. Returns v's position, or that of
+    // the element with its key
+    iterator insert_unique(const_iterator hint, const value_type& v){
+        leaf_node* leaf = hint.node_;
+        size_type i = hint.index_;
+        if(leaf && (i > 0 || !leaf->prev)){
+            const Key& key = KeyOfValue()(v);
+            if(i > 0){
+                const Key& before = KeyOfValue()(leaf->values()[i - 1]);
+                if(!comp_(before, key)){
+                    return comp_(key, before) ? insert_unique(v).first : iterator(leaf, i - 1);
+                }
+            }
+            if(i == leaf->count || comp_(key, KeyOfValue()(leaf->values()[i]))){
+                return insert_at(leaf, i, v);
+            }
+        }
+        return insert_unique(v).first;
+    }
+
+    // insert a range sorted by key, skipping keys already in the tree and
+    // all but the first of equal keys in the range. Into an empty tree the
+    // run is packed into full leaves and the inner levels are built over
+    // them in O(n); into a non-empty one, keys past the largest append
+    // without a descent. Elements out of order are inserted one at a time
+    template <typename InputIt>
+    void insert_sorted_unique(InputIt first, InputIt last){
+        if(!root_){
+            bulk_load(first, last);
+        }
+        for(; first != last; ++first){
+            insert_unique(*first);
+        }
+    }
+
+    void erase(const_iterator pos){
+        erase_at(pos.node_, pos.index_);
+    }
+
+    // K is key_type, or any type a transparent Compare orders against
+    // keys; the containers decide which K they let through
+    template <typename K>
+    iterator find(const K& key){
+        slot_pos at = find_pos(key);
+        return at.leaf ? iterator(at.leaf, at.index) : end();
+    }
+
+    template <typename K>
+    const_iterator find(const K& key) const {
+        slot_pos at = find_pos(key);
+        return at.leaf ? const_iterator(at.leaf, at.index) : end();
+    }
+
+    template <typename K>
+    bool contains(const K& key) const {return find_pos(key).leaf != nullptr;}
+
+    template <typename K>
+    iterator lower_bound(const K& key){
+        slot_pos at = bound_pos<false>(key);
+        return iterator(at.leaf, at.index);
+    }
+
+    template <typename K>
+    const_iterator lower_bound(const K& key) const {
+        slot_pos at = bound_pos<false>(key);
+        return const_iterator(at.leaf, at.index);
+    }
+
+    template <typename K>
+    iterator upper_bound(const K& key){
+        slot_pos at = bound_pos<true>(key);
+        return iterator(at.leaf, at.index);
+    }
+
+    template <typename K>
+    const_iterator upper_bound(const K& key) const {
+        slot_pos at = bound_pos<true>(key);
+        return const_iterator(at.leaf, at.index);
+    }
+
+    template <typename K>
+    mystl::pair<iterator, iterator> equal_range(const K& key){
+        return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+    }
+
+    template <typename K>
+    mystl::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+        return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+    }
+
+    // counts add up whole leaves between the two bounds, so these cost
+    // O(log n + count / leaf_capacity)
+    template <typename K>
+    size_type count(const K& key) const {
+        return slots_between(bound_pos<false>(key), bound_pos<true>(key));
+    }
+
+    // elements with keys in [low, high)
+    template <typename K1, typename K2>
+    size_type count_range(const K1& low, const K2& high) const {
+        if(!comp_(low, high)) return 0;
+        return slots_between(bound_pos<false>(low), bound_pos<false>(high));
+    }
+
+private:
+    // ========= search ========
+    template <typename T>
+    static const Key& key_of(const T& entry) noexcept {
+        if constexpr (std::is_same<T, Key>::value) {
+            return entry;
+        } else {
+            return KeyOfValue()(entry);
+        }
+    }
+
+    // first of n sorted entries (separator keys or leaf elements) not
+    // ordered before key, or with Upper, first ordered after it
+    template <bool Upper, typename T, typename K>
+    size_type search(const T* entries, size_type n, const K& key) const {
+        if constexpr (Upper) {
+            return detail::btree_search<search_window>(entries, n,
+                [&](const T& e){return !comp_(key, key_of(e));});
+        } else {
+            return detail::btree_search<search_window>(entries, n,
+                [&](const T& e){return comp_(key_of(e), key);});
+        }
+    }
+
+    // the leaf slot a lower (or upper) bound search for key stops at. A
+    // separator bounds its subtrees without having to be a live key, so
+    // the bound is this slot or, past the leaf's end, the next leaf's first
+    template <bool Upper, typename K>
+    slot_pos descend(const K& key) const {
+        node_base* n = root_;
+        while(!n->leaf){
+            inner_node* inner = static_cast<inner_node*>(n);
+            n = inner->children[search<Upper>(inner->keys(), inner->count, key)];
+        }
+        leaf_node* leaf = static_cast<leaf_node*>(n);
+        return {leaf, search<Upper>(leaf->values(), leaf->count, key)};
+    }
+
+    // descend, moved off a leaf's end onto the next leaf's first slot;
+    // end() when there is no next leaf
+    template <bool Upper, typename K>
+    slot_pos bound_pos(const K& key) const {
+        if(!root_){
+            return {nullptr, 0};
+        }
+        slot_pos at = descend<Upper>(key);
+        if(at.index == at.leaf->count && at.leaf->next){
+            at = {at.leaf->next, 0};
+        }
+        return at;
+    }
+
+    // elements from first up to (not including) last
+    size_type slots_between(slot_pos first, slot_pos last) const noexcept {
+        size_type n = 0;
+        for(leaf_node* leaf = first.leaf; leaf != last.leaf; leaf = leaf->next){
+            n += leaf->count;
+        }
+        return n - first.index + last.index;
+    }
+
+    template <typename K>
+    slot_pos find_pos(const K& key) const {
+        if(!root_){
+            return {nullptr, 0};
+        }
+        slot_pos at = descend<false>(key);
+        if(at.index == at.leaf->count){
+            if(!at.leaf->next) return {nullptr, 0};
+            at = {at.leaf->next, 0};
+        }
+        if(comp_(key, KeyOfValue()(at.leaf->values()[at.index]))){
+            return {nullptr, 0};
+        }
+        return at;
+    }
+
+    // ========= node create and destroy ========
+    static void set_count(node_base* n, size_type count) noexcept {
+        n->count = static_cast<count_type>(count);
+    }
+
+    leaf_node* init_leaf(leaf_node* n) noexcept {
+        ::new (static_cast<void*>(n)) leaf_node;
+        n->parent = nullptr;
+        n->position = 0;
+        n->count = 0;
+        n->leaf = true;
+        n->prev = n->next = nullptr;
+        return n;
+    }
+
+    inner_node* init_inner(inner_node* n) noexcept {
+        ::new (static_cast<void*>(n)) inner_node;
+        n->parent = nullptr;
+        n->position = 0;
+        n->count = 0;
+        n->leaf = false;
+        return n;
+    }
+
+    void destroy_subtree(node_base* n){
+        if(n->leaf){
+            leaf_node* leaf = static_cast<leaf_node*>(n);
+            Value* values = leaf->values();
+            for(size_type i = 0; i < leaf->count; ++i) values[i].~Value();
+            leaf_alloc_.deallocate(leaf, 1);
+            return;
+        }
+        inner_node* inner = static_cast<inner_node*>(n);
+        for(size_type i = 0; i <= inner->count; ++i) destroy_subtree(inner->children[i]);
+        Key* keys = inner->keys();
+        for(size_type i = 0; i < inner->count; ++i) keys[i].~Key();
+        inner_alloc_.deallocate(inner, 1);
+    }
+
+    // point children [from, count] of n back at n
+    static void adopt(inner_node* n, size_type from) noexcept {
+        for(size_type i = from; i <= n->count; ++i){
+            n->children[i]->parent = n;
+            n->children[i]->position = static_cast<count_type>(i);
+        }
+    }
+
+    // nodes a leaf split needs all the way up, allocated before the tree
+    // is touched so that running out of memory leaves it unchanged
+    struct split_reserve{
+        MyBTree& tree;
+        leaf_node* leaf{nullptr};
+        inner_node* inners{nullptr};    // chained through parent
+
+        split_reserve(MyBTree& t, size_type inner_count) : tree(t) {
+            leaf = tree.leaf_alloc_.allocate(1);
+            try {
+                for(size_type i = 0; i < inner_count; ++i){
+                    inner_node* n = tree.inner_alloc_.allocate(1);
+                    n->parent = inners;
+                    inners = n;
+                }
+            } catch (...) {
+                release();
+                throw;
+            }
+        }
+
+        split_reserve(const split_reserve&) = delete;
+        split_reserve& operator=(const split_reserve&) = delete;
+
+        ~split_reserve() {release();}
+
+        leaf_node* take_leaf() noexcept {
+            leaf_node* n = leaf;
+            leaf = nullptr;
+            return n;
+        }
+
+        inner_node* take_inner() noexcept {
+            inner_node* n = inners;
+            inners = n->parent;
+            return n;
+        }
+
+        void release() noexcept {
+            if(leaf) tree.leaf_alloc_.deallocate(leaf, 1);
+            while(inners) tree.inner_alloc_.deallocate(take_inner(), 1);
+        }
+    };
+
+    // inner nodes a split of n cascades into: one per full ancestor, and a
+    // new root if they reach the top
+    size_type inner_nodes_for_split(const node_base* n) const noexcept {
+        size_type needed = 0;
+        const inner_node* p = n->parent;
+        while(p && p->count == inner_capacity){
+            ++needed;
+            p = p->parent;
+        }
+        return p ? needed : needed + 1;
+    }
+
+    // ========= insert ========
+    iterator insert_first(const value_type& v){
+        leaf_node* leaf = init_leaf(leaf_alloc_.allocate(1));
+        try {
+            ::new (static_cast<void*>(leaf->values())) Value(v);
+        } catch (...) {
+            leaf_alloc_.deallocate(leaf, 1);
+            throw;
+        }
+        leaf->count = 1;
+        root_ = leftmost_ = rightmost_ = leaf;
+        size_ = 1;
+        return iterator(leaf, 0);
+    }
+
+    iterator insert_at(leaf_node* leaf, size_type pos, const value_type& v){
+        if(leaf->count == leaf_capacity){
+            return split_insert(leaf, pos, v);
+        }
+        Value* values = leaf->values();
+        detail::btree_move_slots(values + pos + 1, values + pos, leaf->count - pos);
+        try {
+            ::new (static_cast<void*>(values + pos)) Value(v);
+        } catch (...) {
+            detail::btree_move_slots(values + pos, values + pos + 1, leaf->count - pos);
+            throw;
+        }
+        set_count(leaf, leaf->count + 1);
+        ++size_;
+        return iterator(leaf, pos);
+    }
+
+    // fill leaves from the sorted prefix of [first, last) and build the
+    // tree over them; first is left at the first element out of order
+    template <typename InputIt>
+    void bulk_load(InputIt& first, InputIt last){
+        leaf_node* head = nullptr;
+        leaf_node* tail = nullptr;
+        size_type count = 0;
+        try {
+            for(; first != last; ++first){
+                const value_type& v = *first;
+                if(tail){
+                    const Key& prev = KeyOfValue()(tail->values()[tail->count - 1]);
+                    if(!comp_(prev, KeyOfValue()(v))){
+                        if(comp_(KeyOfValue()(v), prev)) break;
+                        continue;
+                    }
+                }
+                if(!tail || tail->count == leaf_capacity){
+                    leaf_node* leaf = init_leaf(leaf_alloc_.allocate(1));
+                    leaf->prev = tail;
+                    if(tail){
+                        tail->next = leaf;
+                    }else{
+                        head = leaf;
+                    }
+                    tail = leaf;
+                }
+                ::new (static_cast<void*>(tail->values() + tail->count)) Value(v);
+                set_count(tail, tail->count + 1);
+                ++count;
+            }
+            if(!head) return;
+
+            // even out the last two leaves so the tail is not left nearly empty
+            leaf_node* prev = tail->prev;
+            if(prev && tail->count < leaf_min){
+                size_type total = size_type(prev->count) + tail->count;
+                size_type shift = total / 2 - tail->count;
+                Value* values = tail->values();
+                detail::btree_move_slots(values + shift, values, tail->count);
+                detail::btree_move_slots(values, prev->values() + prev->count - shift, shift);
+                set_count(prev, prev->count - shift);
+                set_count(tail, tail->count + shift);
+            }
+            link_leaves(head, tail, count);
+        } catch (...) {
+            while(head){
+                leaf_node* next = head->next;
+                destroy_subtree(head);
+                head = next;
+            }
+            throw;
+        }
+    }
+
+    // build the inner levels over a chain of full leaves, packing each
+    // inner node with as many children as fit. The separator in front of
+    // a child is the largest key under its left neighbour
+    void link_leaves(leaf_node* head, leaf_node* tail, size_type count){
+        std::vector<node_base*> level;
+        std::vector<const Key*> largest;    // largest key under each node of level
+        std::vector<inner_node*> built;
+        try {
+            for(leaf_node* leaf = head; leaf; leaf = leaf->next){
+                level.push_back(leaf);
+                largest.push_back(&KeyOfValue()(leaf->values()[leaf->count - 1]));
+            }
+            while(level.size() > 1){
+                std::vector<node_base*> up;
+                std::vector<const Key*> up_largest;
+                for(size_type i = 0; i < level.size();){
+                    size_type take = level.size() - i;
+                    if(take > inner_capacity + 1){
+                        take = inner_capacity + 1;
+                        // never leave a lone child for the last node
+                        if(level.size() - i - take == 1) --take;
+                    }
+                    built.push_back(nullptr);
+                    inner_node* inner = init_inner(inner_alloc_.allocate(1));
+                    built.back() = inner;
+                    Key* keys = inner->keys();
+                    for(size_type j = 0; j + 1 < take; ++j){
+                        ::new (static_cast<void*>(keys + j)) Key(*largest[i + j]);
+                        set_count(inner, j + 1);
+                    }
+                    for(size_type j = 0; j < take; ++j) inner->children[j] = level[i + j];
+                    adopt(inner, 0);
+                    up.push_back(inner);
+                    up_largest.push_back(largest[i + take - 1]);
+                    i += take;
+                }
+                level.swap(up);
+                largest.swap(up_largest);
+            }
+        } catch (...) {
+            for(inner_node* inner : built){
+                if(!inner) continue;
+                Key* keys = inner->keys();
+                for(size_type j = 0; j < inner->count; ++j) keys[j].~Key();
+                inner_alloc_.deallocate(inner, 1);
+            }
+            throw;
+        }
+        root_ = level[0];
+        root_->parent = nullptr;
+        root_->position = 0;
+        leftmost_ = head;
+        rightmost_ = tail;
+        size_ = count;
+    }
+
+    // split the full leaf and insert v at pos. Appending past the end of
+    // the rightmost leaf moves nothing: the new leaf starts with v alone
+    iterator split_insert(leaf_node* leaf, size_type pos, const value_type& v){
+        size_type total = leaf->count;
+        size_type split = (pos == total && !leaf->next) ? total : total / 2;
+
+        split_reserve spare(*this, inner_nodes_for_split(leaf));
+        Key separator(KeyOfValue()(leaf->values()[split - 1]));
+        detail::btree_slots<Value, 1> incoming;
+        ::new (static_cast<void*>(incoming.data())) Value(v);
+        // nothing below throws
+
+        leaf_node* right = init_leaf(spare.take_leaf());
+        detail::btree_move_slots(right->values(), leaf->values() + split, total - split);
+        set_count(right, total - split);
+        set_count(leaf, split);
+        right->prev = leaf;
+        right->next = leaf->next;
+        if(leaf->next){
+            leaf->next->prev = right;
+        }else{
+            rightmost_ = right;
+        }
+        leaf->next = right;
+
+        leaf_node* target = pos < split ? leaf : right;
+        size_type at = pos < split ? pos : pos - split;
+        Value* values = target->values();
+        detail::btree_move_slots(values + at + 1, values + at, target->count - at);
+        detail::btree_relocate<Value>::apply(values + at, incoming.data());
+        set_count(target, target->count + 1);
+        ++size_;
+
+        insert_into_parent(leaf, std::move(separator), right, spare);
+        return iterator(target, at);
+    }
+
+    // put key and child into n as keys[i] and children[i + 1]; n has room
+    static void inner_insert(inner_node* n, size_type i, Key&& key, node_base* child) noexcept {
+        Key* keys = n->keys();
+        detail::btree_move_slots(keys + i + 1, keys + i, n->count - i);
+        ::new (static_cast<void*>(keys + i)) Key(std::move(key));
+        for(size_type j = n->count + 1; j > i + 1; --j) n->children[j] = n->children[j - 1];
+        n->children[i + 1] = child;
+        set_count(n, n->count + 1);
+        adopt(n, i + 1);
+    }
+
+    // right was split off left: hang it next to left under separator,
+    // splitting full parents on the way up
+    void insert_into_parent(node_base* left, Key&& separator, node_base* right, split_reserve& spare) noexcept {
+        inner_node* parent = left->parent;
+        if(!parent){
+            inner_node* root = init_inner(spare.take_inner());
+            ::new (static_cast<void*>(root->keys())) Key(std::move(separator));
+            root->children[0] = left;
+            root->children[1] = right;
+            root->count = 1;
+            adopt(root, 0);
+            root_ = root;
+            return;
+        }
+
+        size_type i = left->position;
+        if(parent->count < inner_capacity){
+            inner_insert(parent, i, std::move(separator), right);
+            return;
+        }
+
+        // total + 1 keys once separator is in: the first mid stay, the one
+        // after goes up, the rest move to sibling. At the end, keep parent full
+        size_type total = parent->count;
+        size_type mid = i == total ? total - 1 : (total + 1) / 2;
+        inner_node* sibling = init_inner(spare.take_inner());
+        Key* keys = parent->keys();
+        Key* sibling_keys = sibling->keys();
+
+        if(i < mid){
+            detail::btree_move_slots(sibling_keys, keys + mid, total - mid);
+            for(size_type j = mid; j <= total; ++j) sibling->children[j - mid] = parent->children[j];
+            set_count(sibling, total - mid);
+            Key up(std::move(keys[mid - 1]));
+            keys[mid - 1].~Key();
+            set_count(parent, mid - 1);
+            inner_insert(parent, i, std::move(separator), right);
+            adopt(sibling, 0);
+            insert_into_parent(parent, std::move(up), sibling, spare);
+        }else if(i == mid){
+            detail::btree_move_slots(sibling_keys, keys + mid, total - mid);
+            sibling->children[0] = right;
+            for(size_type j = mid + 1; j <= total; ++j) sibling->children[j - mid] = parent->children[j];
+            set_count(sibling, total - mid);
+            set_count(parent, mid);
+            adopt(sibling, 0);
+            insert_into_parent(parent, std::move(separator), sibling, spare);
+        }else{
+            detail::btree_move_slots(sibling_keys, keys + mid + 1, total - mid - 1);
+            for(size_type j = mid + 1; j <= total; ++j) sibling->children[j - mid - 1] = parent->children[j];
+            set_count(sibling, total - mid - 1);
+            Key up(std::move(keys[mid]));
+            keys[mid].~Key();
+            set_count(parent, mid);
+            adopt(sibling, 0);
+            inner_insert(sibling, i - mid - 1, std::move(separator), right);
+            insert_into_parent(parent, std::move(up), sibling, spare);
+        }
+    }
+
+    // ========= erase ========
+    void erase_at(leaf_node* leaf, size_type i){
+        Value* values = leaf->values();
+        values[i].~Value();
+        detail::btree_move_slots(values + i, values + i + 1, leaf->count - i - 1);
+        set_count(leaf, leaf->count - 1);
+        --size_;
+
+        if(leaf == root_){
+            if(leaf->count == 0){
+                leaf_alloc_.deallocate(leaf, 1);
+                root_ = nullptr;
+                leftmost_ = rightmost_ = nullptr;
+            }
+            return;
+        }
+        if(leaf->count < leaf_min){
+            rebalance_leaf(leaf);
+        }
+    }
+
+    // leaf fell under half full: take an element from a sibling that can
+    // spare one, or merge with a sibling
+    void rebalance_leaf(leaf_node* leaf){
+        inner_node* parent = leaf->parent;
+        size_type i = leaf->position;
+        leaf_node* left = i > 0 ? static_cast<leaf_node*>(parent->children[i - 1]) : nullptr;
+        leaf_node* right = i < parent->count ? static_cast<leaf_node*>(parent->children[i + 1]) : nullptr;
+
+        if(left && left->count > leaf_min){
+            Key separator(KeyOfValue()(left->values()[left->count - 2]));
+            Value* values = leaf->values();
+            detail::btree_move_slots(values + 1, values, leaf->count);
+            detail::btree_relocate<Value>::apply(values, left->values() + left->count - 1);
+            set_count(left, left->count - 1);
+            set_count(leaf, leaf->count + 1);
+            parent->keys()[i - 1] = std::move(separator);
+        }else if(right && right->count > leaf_min){
+            Key separator(KeyOfValue()(right->values()[0]));
+            Value* values = right->values();
+            detail::btree_relocate<Value>::apply(leaf->values() + leaf->count, values);
+            detail::btree_move_slots(values, values + 1, right->count - 1);
+            set_count(right, right->count - 1);
+            set_count(leaf, leaf->count + 1);
+            parent->keys()[i] = std::move(separator);
+        }else if(left){
+            merge_leaves(left, leaf);
+        }else{
+            merge_leaves(leaf, right);
+        }
+    }
+
+    // move right's elements onto the end of left, its neighbour under the
+    // same parent, and drop right
+    void merge_leaves(leaf_node* left, leaf_node* right){
+        detail::btree_move_slots(left->values() + left->count, right->values(), right->count);
+        set_count(left, left->count + right->count);
+        left->next = right->next;
+        if(right->next){
+            right->next->prev = left;
+        }else{
+            rightmost_ = left;
+        }
+        inner_node* parent = right->parent;
+        size_type i = right->position;
+        leaf_alloc_.deallocate(right, 1);
+        remove_from_inner(parent, i - 1);
+    }
+
+    // drop keys[i] and children[i + 1] of n, whose child is already gone
+    void remove_from_inner(inner_node* n, size_type i){
+        Key* keys = n->keys();
+        keys[i].~Key();
+        detail::btree_move_slots(keys + i, keys + i + 1, n->count - i - 1);
+        for(size_type j = i + 1; j < n->count; ++j) n->children[j] = n->children[j + 1];
+        set_count(n, n->count - 1);
+        adopt(n, i + 1);
+
+        if(n == root_){
+            if(n->count == 0){
+                root_ = n->children[0];
+                root_->parent = nullptr;
+                root_->position = 0;
+                inner_alloc_.deallocate(n, 1);
+            }
+            return;
+        }
+        if(n->count < inner_min){
+            rebalance_inner(n);
+        }
+    }
+
+    // like rebalance_leaf, but keys rotate through the parent's separator
+    void rebalance_inner(inner_node* n){
+        inner_node* parent = n->parent;
+        size_type i = n->position;
+        inner_node* left = i > 0 ? static_cast<inner_node*>(parent->children[i - 1]) : nullptr;
+        inner_node* right = i < parent->count ? static_cast<inner_node*>(parent->children[i + 1]) : nullptr;
+        Key* keys = n->keys();
+
+        if(left && left->count > inner_min){
+            Key* left_keys = left->keys();
+            detail::btree_move_slots(keys + 1, keys, n->count);
+            ::new (static_cast<void*>(keys)) Key(std::move(parent->keys()[i - 1]));
+            parent->keys()[i - 1] = std::move(left_keys[left->count - 1]);
+            left_keys[left->count - 1].~Key();
+            for(size_type j = n->count + 1; j > 0; --j) n->children[j] = n->children[j - 1];
+            n->children[0] = left->children[left->count];
+            set_count(left, left->count - 1);
+            set_count(n, n->count + 1);
+            adopt(n, 0);
+        }else if(right && right->count > inner_min){
+            Key* right_keys = right->keys();
+            ::new (static_cast<void*>(keys + n->count)) Key(std::move(parent->keys()[i]));
+            n->children[n->count + 1] = right->children[0];
+            parent->keys()[i] = std::move(right_keys[0]);
+            right_keys[0].~Key();
+            detail::btree_move_slots(right_keys, right_keys + 1, right->count - 1);
+            for(size_type j = 0; j < right->count; ++j) right->children[j] = right->children[j + 1];
+            set_count(right, right->count - 1);
+            set_count(n, n->count + 1);
+            adopt(n, n->count);
+            adopt(right, 0);
+        }else if(left){
+            merge_inners(left, n);
+        }else{
+            merge_inners(n, right);
+        }
+    }
+
+    // pull the separator between left and right down into left, append
+    // right's keys and children, and drop right
+    void merge_inners(inner_node* left, inner_node* right){
+        inner_node* parent = right->parent;
+        size_type i = right->position;
+        Key* left_keys = left->keys();
+        size_type base = left->count;
+
+        ::new (static_cast<void*>(left_keys + base)) Key(std::move(parent->keys()[i - 1]));
+        detail::btree_move_slots(left_keys + base + 1, right->keys(), right->count);
+        for(size_type j = 0; j <= right->count; ++j) left->children[base + 1 + j] = right->children[j];
+        set_count(left, base + 1 + right->count);
+        adopt(left, base + 1);
+        inner_alloc_.deallocate(right, 1);
+        remove_from_inner(parent, i - 1);
+    }
+};
+
+// backend tag for the ordered containers (MyMap, MySet, MyMultimap,
+// MyMultiset): pass mystl::btree_backend<> as their TreeBackend to store
+// them in a MyBTree with NodeBytes sized nodes
+template <std::size_t NodeBytes = btree_default_node_bytes>
+struct btree_backend{
+    template <typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc>
+    using tree = MyBTree<Key, Value, KeyOfValue, Compare, Alloc, NodeBytes>;
+};
+
+} // namespace mystl
+#endif // MY_BTREE_H
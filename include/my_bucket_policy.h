@@ -0,0 +1,127 @@
+#ifndef MY_BUCKET_POLICY_H
+#define MY_BUCKET_POLICY_H
+
+#include "my_utility.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mystl{
+
+// ===============================
+// bucket index policies
+// ===============================
+// A bucket policy turns a hash into a bucket index for MyHashTable. It is
+// any class with
+//
+//     static std::size_t bucket_count_for(std::size_t requested);
+//     void reset(std::size_t bucket_count);      // bucket array resized
+//     std::size_t index(std::size_t hash) const; // in [0, bucket_count)
+//
+// bucket_count_for rounds a requested count up to one the policy can index,
+// reset precomputes whatever index needs, and index runs on every lookup.
+// MyHashTable hands index a hash already passed through bucket_mix (or one
+// from an avalanching hasher), so a policy may use any of its bits.
+
+// high 64 bits of a 64 x 64 bit product
+inline std::uint64_t mul_high_u64(std::uint64_t a, std::uint64_t b) noexcept {
+    std::uint64_t hi;
+    mystl::mul_u64_wide(a, b, hi);
+    return hi;
+}
+
+// MurmurHash3's fmix64 finalizer: every output bit depends on every input
+// bit, so any slice of the result (the low bits for a mask, the high ones
+// for fastrange) can index buckets. std::hash on integers is the identity
+// and would otherwise leave most of its bits unused. Callers skip it for a
+// hasher that declares is_avalanching
+inline std::uint64_t bucket_mix(std::uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// hash % n: any bucket count, one integer division per lookup
+struct mod_bucket_policy{
+    std::size_t count_{1};
+
+    static std::size_t bucket_count_for(std::size_t n) noexcept {
+        return n ? n : 1;
+    }
+
+    void reset(std::size_t bucket_count) noexcept {count_ = bucket_count;}
+
+    std::size_t index(std::size_t hash) const noexcept {return hash % count_;}
+};
+
+// power of two bucket counts: mask the low bits
+struct pow2_bucket_policy{
+    std::size_t mask_{0};
+
+    static std::size_t bucket_count_for(std::size_t n) noexcept {
+        std::size_t count = 1;
+        while (count < n) count <<= 1;
+        return count;
+    }
+
+    void reset(std::size_t bucket_count) noexcept {mask_ = bucket_count - 1;}
+
+    std::size_t index(std::size_t hash) const noexcept {
+        return hash & mask_;
+    }
+};
+
+// Lemire's fastrange: map the hash onto [0, n) with a multiply and a
+// shift, for any bucket count
+struct fastrange_bucket_policy{
+    std::uint64_t count_{1};
+
+    static std::size_t bucket_count_for(std::size_t n) noexcept {
+        return n ? n : 1;
+    }
+
+    void reset(std::size_t bucket_count) noexcept {count_ = bucket_count;}
+
+    std::size_t index(std::size_t hash) const noexcept {
+        return static_cast<std::size_t>(mul_high_u64(hash, count_));
+    }
+};
+
+// prime bucket counts, which tolerate weak hashes best. The modulo uses a
+// reciprocal computed once per resize (Lemire's fastmod) instead of a
+// division per lookup; the hash is folded to 32 bits for it
+struct prime_bucket_policy{
+    std::uint64_t prime_{1};
+    std::uint64_t reciprocal_{0};
+
+    static std::size_t bucket_count_for(std::size_t n) noexcept {
+        static const std::uint32_t primes[] = {
+            5u, 11u, 23u, 47u, 97u, 199u, 409u, 823u, 1741u, 3469u, 6949u, 14033u,
+            28411u, 57557u, 116731u, 236897u, 480881u, 976369u, 1982627u, 4026031u,
+            8175383u, 16601593u, 33712729u, 68460391u, 139022417u, 282312799u,
+            573292817u, 1164186217u, 2364114217u, 4294967291u};
+        for (std::uint32_t p : primes) {
+            if (p >= n) return p;
+        }
+        return 4294967291u;
+    }
+
+    void reset(std::size_t bucket_count) noexcept {
+        prime_ = bucket_count;
+        reciprocal_ = ~std::uint64_t(0) / prime_ + 1;
+    }
+
+    std::size_t index(std::size_t hash) const noexcept {
+        std::uint64_t h = static_cast<std::uint64_t>(hash);
+        std::uint32_t folded = static_cast<std::uint32_t>(h ^ (h >> 32));
+        std::uint64_t low = reciprocal_ * folded;
+        return static_cast<std::size_t>(mul_high_u64(low, prime_));
+    }
+};
+
+} // namespace mystl
+
+#endif // MY_BUCKET_POLICY_H
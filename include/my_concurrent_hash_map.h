@@ -0,0 +1,314 @@
+#ifndef MY_CONCURRENT_HASH_MAP_H
+#define MY_CONCURRENT_HASH_MAP_H
+
+#include "my_hashtable.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace mystl{
+
+// ===============================
+// shard reader/writer lock
+// ===============================
+// One word: the reader count in the low bits, plus a writer bit and a
+// writer-pending bit that stops new readers so writers are not starved by
+// a steady stream of lookups. Waiters spin briefly and then yield, which
+// keeps the short critical sections of a shard cheap under contention;
+// std::shared_mutex waiters on glibc burn their whole time slice when the
+// holder is descheduled. Meets SharedMutex, so std::unique_lock and
+// std::shared_lock work with it.
+class shard_rw_lock{
+    static constexpr std::uint32_t writer = 1u << 31;
+    static constexpr std::uint32_t pending = 1u << 30;
+    static constexpr unsigned spins_before_yield = 64;
+
+    std::atomic<std::uint32_t> state_{0};
+
+    static void backoff(unsigned& spins) noexcept {
+        if(++spins >= spins_before_yield){
+            spins = 0;
+            std::this_thread::yield();
+        }
+    }
+
+public:
+    shard_rw_lock() = default;
+    shard_rw_lock(const shard_rw_lock&) = delete;
+    shard_rw_lock& operator=(const shard_rw_lock&) = delete;
+
+    void lock() noexcept {
+        unsigned spins = 0;
+        for(;;){
+            std::uint32_t s = state_.load(std::memory_order_relaxed);
+            if((s & ~pending) == 0){
+                // clears pending as well; other waiting writers set it again
+                if(state_.compare_exchange_weak(s, writer, std::memory_order_acquire,
+                                                std::memory_order_relaxed)) return;
+            }else if(!(s & pending)){
+                state_.fetch_or(pending, std::memory_order_relaxed);
+            }
+            backoff(spins);
+        }
+    }
+
+    bool try_lock() noexcept {
+        std::uint32_t s = state_.load(std::memory_order_relaxed);
+        return (s & ~pending) == 0 &&
+               state_.compare_exchange_strong(s, writer, std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept {state_.fetch_and(~writer, std::memory_order_release);}
+
+    void lock_shared() noexcept {
+        unsigned spins = 0;
+        for(;;){
+            std::uint32_t s = state_.load(std::memory_order_relaxed);
+            if(!(s & (writer | pending)) &&
+               state_.compare_exchange_weak(s, s + 1, std::memory_order_acquire,
+                                            std::memory_order_relaxed)) return;
+            backoff(spins);
+        }
+    }
+
+    bool try_lock_shared() noexcept {
+        std::uint32_t s = state_.load(std::memory_order_relaxed);
+        return !(s & (writer | pending)) &&
+               state_.compare_exchange_strong(s, s + 1, std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+
+    void unlock_shared() noexcept {state_.fetch_sub(1, std::memory_order_release);}
+};
+
+// ===============================
+// concurrent sharded hash map
+// ===============================
+// The key space is split across a power-of-two number of MyHashTable
+// shards, each guarded by its own shard_rw_lock. Lookups take the shard
+// lock shared and copy the value out; every operation that modifies the
+// map, including the read-modify-write ones (upsert, compute_if_absent),
+// runs under the shard lock held exclusively and is therefore atomic with
+// respect to the key. Threads working on different shards never touch the
+// same lock.
+//
+// Shards are aligned to a cache line so a writer spinning on one shard's
+// lock does not invalidate the line of its neighbour. The key is hashed
+// once per operation: the shard is chosen from the middle bits of that
+// hash and the shard's table indexes its buckets with the same value, from
+// bits the shard choice leaves free, so one shard's keys still spread over
+// all of its buckets.
+//
+// No references into the map are handed out: values are copied, or a
+// visitor runs while the lock is held.
+template <
+    typename Key,
+    typename Value,
+    typename Hash = mystl::hash<Key>,
+    typename KeyEqual = mystl::equal_to<Key>,
+    typename Alloc = mystl::MyAllocator<hash_node<Key, Value>>,
+    typename BucketPolicy = mystl::pow2_bucket_policy>
+class MyConcurrentHashMap{
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = std::size_t;
+    using table_type = MyHashTable<Key, Value, Hash, KeyEqual, Alloc, BucketPolicy>;
+
+    static constexpr size_type cache_line = 64;
+    static constexpr size_type default_shard_count = 64;
+
+private:
+    static constexpr unsigned shard_bits_offset =
+        static_cast<unsigned>(std::numeric_limits<size_type>::digits) / 2;
+
+    struct alignas(cache_line) shard{
+        mutable shard_rw_lock lock;
+        table_type table;
+    };
+
+    using shared_lock = std::shared_lock<shard_rw_lock>;
+    using unique_lock = std::unique_lock<shard_rw_lock>;
+
+    std::unique_ptr<shard[]> shards_;
+    size_type shard_count_;
+    size_type shard_mask_;
+    Hash hasher_;
+
+public:
+    // shard_count is rounded up to a power of two
+    explicit MyConcurrentHashMap(size_type shard_count = default_shard_count)
+        : shard_count_(pow2_bucket_policy::bucket_count_for(shard_count)),
+          shard_mask_(shard_count_ - 1) {
+        shards_.reset(new shard[shard_count_]);
+    }
+
+    MyConcurrentHashMap(const MyConcurrentHashMap&) = delete;
+    MyConcurrentHashMap& operator=(const MyConcurrentHashMap&) = delete;
+
+    size_type shard_count() const noexcept {return shard_count_;}
+
+    // a sum over the shards taken one at a time: exact only while no other
+    // thread is writing
+    size_type size() const {
+        size_type n = 0;
+        for(size_type i = 0; i < shard_count_; ++i){
+            shared_lock guard(shards_[i].lock);
+            n += shards_[i].table.size();
+        }
+        return n;
+    }
+
+    bool empty() const {return size() == 0;}
+
+    void clear(){
+        for(size_type i = 0; i < shard_count_; ++i){
+            unique_lock guard(shards_[i].lock);
+            shards_[i].table.clear();
+        }
+    }
+
+    // room for about n elements spread evenly over the shards
+    void reserve(size_type n){
+        size_type per_shard = n / shard_count_ + 1;
+        for(size_type i = 0; i < shard_count_; ++i){
+            unique_lock guard(shards_[i].lock);
+            shards_[i].table.reserve(per_shard);
+        }
+    }
+
+    // copy the value of key into out
+    bool find(const Key& key, Value& out) const {
+        size_type hash = hash_of(key);
+        const shard& s = shard_at(hash);
+        shared_lock guard(s.lock);
+        const Value* value = s.table.find_hashed(key, hash);
+        if(!value) return false;
+        out = *value;
+        return true;
+    }
+
+    bool contains(const Key& key) const {
+        size_type hash = hash_of(key);
+        const shard& s = shard_at(hash);
+        shared_lock guard(s.lock);
+        return s.table.contains_hashed(key, hash);
+    }
+
+    // call f(const Value&) under the shared lock; false if key is absent
+    template <typename F>
+    bool visit(const Key& key, F&& f) const {
+        size_type hash = hash_of(key);
+        const shard& s = shard_at(hash);
+        shared_lock guard(s.lock);
+        const Value* value = s.table.find_hashed(key, hash);
+        if(!value) return false;
+        f(*value);
+        return true;
+    }
+
+    // insert or overwrite, like MyUnorderedMap::insert
+    void insert(const Key& key, const Value& value){
+        insert_or_assign(key, value);
+    }
+
+    // true if args built a new value, false if key was already present
+    template <typename... Args>
+    bool try_emplace(const Key& key, Args&&... args){
+        size_type hash = hash_of(key);
+        shard& s = shard_at(hash);
+        unique_lock guard(s.lock);
+        return s.table.try_emplace_hashed(key, hash, mystl::forward<Args>(args)...).second;
+    }
+
+    // true for an insert, false for an assignment
+    template <typename M>
+    bool insert_or_assign(const Key& key, M&& obj){
+        size_type hash = hash_of(key);
+        shard& s = shard_at(hash);
+        unique_lock guard(s.lock);
+        return s.table.insert_or_assign_hashed(key, hash, mystl::forward<M>(obj)).second;
+    }
+
+    // Atomically call update(Value&) on the value of key if it is present,
+    // or insert Value(args...) if it is not. True for an insert. Keep
+    // update short: the whole shard is locked while it runs.
+    template <typename F, typename... Args>
+    bool upsert(const Key& key, F&& update, Args&&... args){
+        size_type hash = hash_of(key);
+        shard& s = shard_at(hash);
+        unique_lock guard(s.lock);
+        if(Value* value = s.table.find_hashed(key, hash)){
+            update(*value);
+            return false;
+        }
+        s.table.try_emplace_hashed(key, hash, mystl::forward<Args>(args)...);
+        return true;
+    }
+
+    // Return the value of key, inserting make() first if key is absent.
+    // make runs at most once per key, under the exclusive lock; a present
+    // key is served under the shared lock only.
+    template <typename F>
+    Value compute_if_absent(const Key& key, F&& make){
+        size_type hash = hash_of(key);
+        shard& s = shard_at(hash);
+        {
+            // the const find, which never migrates buckets under a shared lock
+            const table_type& table = s.table;
+            shared_lock guard(s.lock);
+            if(const Value* value = table.find_hashed(key, hash)) return *value;
+        }
+        unique_lock guard(s.lock);
+        // another writer may have inserted it between the two locks
+        if(const Value* value = s.table.find_hashed(key, hash)) return *value;
+        return s.table.try_emplace_hashed(key, hash, make()).first->second;
+    }
+
+    bool erase(const Key& key){
+        size_type hash = hash_of(key);
+        shard& s = shard_at(hash);
+        unique_lock guard(s.lock);
+        return s.table.erase_hashed(key, hash);
+    }
+
+    // call f(const Key&, const Value&) on every element, one shard at a time
+    // under its shared lock; not a snapshot of the whole map
+    template <typename F>
+    void for_each(F&& f) const {
+        for(size_type i = 0; i < shard_count_; ++i){
+            shared_lock guard(shards_[i].lock);
+            for(const auto& kv : shards_[i].table) f(kv.first, kv.second);
+        }
+    }
+
+private:
+    // the same value as table_type::hash_value(key): the shard comes from
+    // its top bits and the shard's table is handed it, so each operation
+    // hashes the key once
+    size_type hash_of(const Key& key) const {
+        std::uint64_t h = static_cast<std::uint64_t>(hasher_(key));
+        if constexpr(!mystl::hash_is_avalanching<Hash>::value) h = bucket_mix(h);
+        return static_cast<size_type>(h);
+    }
+
+    // bits from the middle of the hash: the pow2 policy indexes buckets
+    // from the low bits and fastrange from the high ones
+    size_type shard_index(size_type hash) const noexcept {
+        return (hash >> shard_bits_offset) & shard_mask_;
+    }
+
+    shard& shard_at(size_type hash){return shards_[shard_index(hash)];}
+    const shard& shard_at(size_type hash) const {return shards_[shard_index(hash)];}
+};
+
+} // namespace mystl
+
+#endif // MY_CONCURRENT_HASH_MAP_H
@@ -3,6 +3,8 @@
 
 #include "my_allocator.h"
 #include "my_iterator.h"
+#include "my_utility.h"
+#include "my_algorithm.h"
 
 #include <cstddef>
 
@@ -81,6 +83,7 @@ public:
     using value_type = T;
     using allocator_type = Alloc;
     using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
     using reference = value_type&;
     using const_reference = const value_type&;
     using iterator = deque_iterator<T, T&, T*>;
@@ -266,38 +269,96 @@ public:
     
 
     void push_back(const_reference value){
+        emplace_back(value);
+    }
+
+    void push_back(value_type&& value){
+        emplace_back(mystl::move(value));
+    }
+
+    void push_front(const_reference value){
+        emplace_front(value);
+    }
+
+    void push_front(value_type&& value){
+        emplace_front(mystl::move(value));
+    }
+
+    template <class... Args>
+    reference emplace_back(Args&&... args){
         if (!map_) create_map_and_nodes(0);
         
         if (finish_.cur != finish_.last - 1){
             // Construct in-place
-            alloc_.construct(finish_.cur, value);
+            alloc_.construct(finish_.cur, mystl::forward<Args>(args)...);
             ++finish_.cur;
         } else {
             // Allocate new block at back
             reserve_map_at_back(1);
             *(finish_.node + 1) = allocate_node();
-            alloc_.construct(finish_.cur, value);
+            alloc_.construct(finish_.cur, mystl::forward<Args>(args)...);
             finish_.set_node(finish_.node + 1);
             finish_.cur = finish_.first;
         }
         ++size_;
+        return back();
     }
     
-    void push_front(const_reference value){
+    template <class... Args>
+    reference emplace_front(Args&&... args){
         if (!map_) create_map_and_nodes(0);
         
         if (start_.cur != start_.first){
+            alloc_.construct(start_.cur - 1, mystl::forward<Args>(args)...);
             --start_.cur;
-            alloc_.construct(start_.cur, value);
         } else {
             // Allocate new block at front
             reserve_map_at_front(1);
             *(start_.node - 1) = allocate_node();
+            alloc_.construct(*(start_.node - 1) + (buffer_size() - 1), mystl::forward<Args>(args)...);
             start_.set_node(start_.node - 1);
             start_.cur = start_.last - 1;
-            alloc_.construct(start_.cur, value);
         }
         ++size_;
+        return *start_;
+    }
+
+    // construct before pos, shifting whichever half of the deque is shorter
+    template <class... Args>
+    iterator emplace(iterator pos, Args&&... args){
+        if (pos == start_){
+            emplace_front(mystl::forward<Args>(args)...);
+            return start_;
+        }
+        if (pos == finish_){
+            emplace_back(mystl::forward<Args>(args)...);
+            return finish_ - 1;
+        }
+
+        // args may refer to an element of this deque: build the value first
+        value_type tmp(mystl::forward<Args>(args)...);
+        difference_type index = pos - start_;
+        if (static_cast<size_type>(index) < size_ / 2){
+            emplace_front(mystl::move(front()));
+            iterator front1 = start_ + 1;
+            pos = start_ + index;
+            mystl::move(front1 + 1, pos + 1, front1);
+        } else {
+            emplace_back(mystl::move(back()));
+            iterator back1 = finish_ - 1;
+            pos = start_ + index;
+            mystl::move_backward(pos, back1 - 1, back1);
+        }
+        *pos = mystl::move(tmp);
+        return pos;
+    }
+
+    iterator insert(iterator pos, const_reference value){
+        return emplace(pos, value);
+    }
+
+    iterator insert(iterator pos, value_type&& value){
+        return emplace(pos, mystl::move(value));
     }
     
     void pop_back(){
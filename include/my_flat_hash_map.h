@@ -0,0 +1,601 @@
+#ifndef MY_FLAT_HASH_MAP
+#define MY_FLAT_HASH_MAP
+
+#include "mystl_config.h"
+#include "my_allocator.h"
+#include "my_iterator.h"
+#include "my_uninitialized.h"
+#include "my_utility.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+
+#if MYSTL_HAS_AVX2
+#include <immintrin.h>
+#elif MYSTL_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace mystl{
+
+// ======================
+// Control bytes
+// ======================
+// every slot has one control byte: a full slot stores the low 7 bits of its
+// hash (0..127), the other states are negative so one signed compare
+// separates them
+using flat_ctrl_t = signed char;
+
+constexpr flat_ctrl_t flat_ctrl_empty = -128;
+constexpr flat_ctrl_t flat_ctrl_deleted = -2;
+constexpr flat_ctrl_t flat_ctrl_sentinel = -1;
+
+inline unsigned flat_ctz(std::uint32_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(x));
+#else
+    unsigned n = 0;
+    while (!(x & 1u)) { x >>= 1; ++n; }
+    return n;
+#endif
+}
+
+inline unsigned flat_clz(std::uint32_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_clz(x));
+#else
+    unsigned n = 0;
+    while (!(x & 0x80000000u)) { x <<= 1; ++n; }
+    return n;
+#endif
+}
+
+// ======================
+// Group: control bytes scanned together
+// ======================
+// match*() return one bit per slot of the group, lowest bit = first slot
+struct flat_group{
+#if MYSTL_HAS_AVX2
+    static constexpr std::size_t width = 32;
+
+    __m256i ctrl;
+
+    explicit flat_group(const flat_ctrl_t* p)
+        : ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))) {}
+
+    std::uint32_t match(flat_ctrl_t h2) const noexcept {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl)));
+    }
+
+    std::uint32_t match_empty() const noexcept {
+        return match(flat_ctrl_empty);
+    }
+
+    std::uint32_t match_empty_or_deleted() const noexcept {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(
+            _mm256_cmpgt_epi8(_mm256_set1_epi8(flat_ctrl_sentinel), ctrl)));
+    }
+#elif MYSTL_HAS_SSE2
+    static constexpr std::size_t width = 16;
+
+    __m128i ctrl;
+
+    explicit flat_group(const flat_ctrl_t* p)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    std::uint32_t match(flat_ctrl_t h2) const noexcept {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+    }
+
+    std::uint32_t match_empty() const noexcept {
+        return match(flat_ctrl_empty);
+    }
+
+    std::uint32_t match_empty_or_deleted() const noexcept {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(
+            _mm_cmpgt_epi8(_mm_set1_epi8(flat_ctrl_sentinel), ctrl)));
+    }
+#else
+    static constexpr std::size_t width = 8;
+
+    flat_ctrl_t ctrl[width];
+
+    explicit flat_group(const flat_ctrl_t* p) {
+        std::memcpy(ctrl, p, width);
+    }
+
+    std::uint32_t match(flat_ctrl_t h2) const noexcept {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < width; ++i) {
+            if (ctrl[i] == h2) mask |= 1u << i;
+        }
+        return mask;
+    }
+
+    std::uint32_t match_empty() const noexcept {
+        return match(flat_ctrl_empty);
+    }
+
+    std::uint32_t match_empty_or_deleted() const noexcept {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < width; ++i) {
+            if (ctrl[i] < flat_ctrl_sentinel) mask |= 1u << i;
+        }
+        return mask;
+    }
+#endif
+};
+
+// control bytes of a table with no slots: lookups see an empty slot
+// right away and stop, without a capacity check on the hot path
+inline flat_ctrl_t* flat_empty_group() noexcept {
+    alignas(32) static flat_ctrl_t group[32] = {
+        flat_ctrl_sentinel,
+        flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty,
+        flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty,
+        flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty,
+        flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty,
+        flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty,
+        flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty,
+        flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty,
+        flat_ctrl_empty, flat_ctrl_empty, flat_ctrl_empty};
+    return group;
+}
+
+// spread the hash so both the probe start (high bits) and the 7-bit tag
+// (low bits) are usable even when Hash is the identity on integers
+inline std::size_t flat_hash_mix(std::size_t h) noexcept {
+    std::uint64_t x = static_cast<std::uint64_t>(h);
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<std::size_t>(x);
+}
+
+// ======================
+// flat hash map iterator
+// ======================
+template <typename Value>
+class flat_hash_iterator{
+public:
+    using iterator_category = mystl::forward_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+private:
+    const flat_ctrl_t* ctrl_{nullptr};
+    pointer slot_{nullptr};
+
+public:
+    flat_hash_iterator() = default;
+
+    flat_hash_iterator(const flat_ctrl_t* ctrl, pointer slot) : ctrl_(ctrl), slot_(slot) {
+        skip_empty_or_deleted();
+    }
+
+    reference operator*() const {return *slot_;}
+    pointer operator->() const {return slot_;}
+
+    flat_hash_iterator& operator++(){
+        ++ctrl_;
+        ++slot_;
+        skip_empty_or_deleted();
+        return *this;
+    }
+
+    flat_hash_iterator operator++(int){
+        flat_hash_iterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const flat_hash_iterator& other) const {return ctrl_ == other.ctrl_;}
+    bool operator!=(const flat_hash_iterator& other) const {return ctrl_ != other.ctrl_;}
+
+private:
+    // the sentinel after the last slot stops the walk
+    void skip_empty_or_deleted(){
+        while (*ctrl_ < flat_ctrl_sentinel) {
+            ++ctrl_;
+            ++slot_;
+        }
+    }
+};
+
+// =====================
+// Flat Hash Map
+// =====================
+// open addressing in the Swiss table style: keys live directly in one slot
+// array, and a parallel array of control bytes is probed a whole group at a
+// time with SIMD compares. A lookup touches the control bytes and then,
+// almost always, a single slot
+template <
+    typename Key,
+    typename Value,
+    typename Hash = mystl::hash<Key>,
+    typename KeyEqual = mystl::equal_to<Key>,
+    typename Alloc = mystl::MyAllocator<mystl::pair<Key, Value>>>
+class MyFlatHashMap{
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = mystl::pair<Key, Value>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Alloc;
+    using iterator = flat_hash_iterator<value_type>;
+    using const_iterator = flat_hash_iterator<const value_type>;
+
+    static constexpr size_type group_width = flat_group::width;
+
+private:
+    using slot_type = value_type;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    flat_ctrl_t* ctrl_{flat_empty_group()};
+    slot_type* slots_{nullptr};
+    size_type capacity_{0};        // 0 or 2^k - 1, doubles as the probe mask
+    size_type size_{0};
+    size_type growth_left_{0};     // inserts into empty slots before a resize
+    Hash hasher_;
+    KeyEqual key_equal_;
+    allocator_type alloc_;
+
+public:
+    explicit MyFlatHashMap(size_type bucket_count = 0){
+        if (bucket_count) rehash(bucket_count);
+    }
+
+    MyFlatHashMap(const MyFlatHashMap& other)
+        : hasher_(other.hasher_), key_equal_(other.key_equal_), alloc_(other.alloc_) {
+        reserve(other.size_);
+        for (const auto& slot : other) {
+            insert(slot.first, slot.second);
+        }
+    }
+
+    MyFlatHashMap(MyFlatHashMap&& other) noexcept
+        : ctrl_(other.ctrl_), slots_(other.slots_), capacity_(other.capacity_),
+          size_(other.size_), growth_left_(other.growth_left_),
+          hasher_(other.hasher_), key_equal_(other.key_equal_), alloc_(other.alloc_) {
+        other.reset_to_empty();
+    }
+
+    MyFlatHashMap& operator=(MyFlatHashMap other){
+        swap(other);
+        return *this;
+    }
+
+    ~MyFlatHashMap(){
+        destroy_slots();
+        deallocate_storage();
+    }
+
+    bool empty() const noexcept {return size_ == 0;}
+    size_type size() const noexcept {return size_;}
+    size_type bucket_count() const noexcept {return capacity_;}
+
+    float load_factor() const noexcept {
+        return capacity_ ? static_cast<float>(size_) / static_cast<float>(capacity_) : 0.0f;
+    }
+
+    // fixed: a group has to keep at least one empty slot most of the time
+    float max_load_factor() const noexcept {return 0.875f;}
+
+    iterator begin() noexcept {return iterator(ctrl_, slots_);}
+    iterator end() noexcept {return iterator(ctrl_ + capacity_, slots_ + capacity_);}
+    const_iterator begin() const noexcept {return const_iterator(ctrl_, slots_);}
+    const_iterator end() const noexcept {return const_iterator(ctrl_ + capacity_, slots_ + capacity_);}
+
+    // keeps the slot array, like MyVector::clear
+    void clear() noexcept {
+        if (!capacity_) return;
+        destroy_slots();
+        reset_ctrl();
+        size_ = 0;
+        growth_left_ = capacity_to_growth(capacity_);
+    }
+
+    // insert or overwrite, like MyHashTable::insert
+    void insert(const Key& key, const Value& value){
+        size_type hash = hash_of(key);
+        size_type idx = find_index(key, hash);
+        if (idx != npos) {
+            slots_[idx].second = value;
+            return;
+        }
+        emplace_at(prepare_insert(hash), hash, key, value);
+    }
+
+    Value* find(const Key& key){
+        size_type idx = find_index(key, hash_of(key));
+        return idx == npos ? nullptr : &slots_[idx].second;
+    }
+
+    const Value* find(const Key& key) const{
+        size_type idx = find_index(key, hash_of(key));
+        return idx == npos ? nullptr : &slots_[idx].second;
+    }
+
+    bool contains(const Key& key) const{
+        return find_index(key, hash_of(key)) != npos;
+    }
+
+    size_type count(const Key& key) const{
+        return contains(key) ? 1 : 0;
+    }
+
+    bool erase(const Key& key){
+        size_type idx = find_index(key, hash_of(key));
+        if (idx == npos) return false;
+        erase_at(idx);
+        return true;
+    }
+
+    // one probe: a miss inserts into the slot the lookup already found
+    Value& operator[](const Key& key){
+        size_type hash = hash_of(key);
+        size_type idx = find_index(key, hash);
+        if (idx == npos) {
+            idx = prepare_insert(hash);
+            emplace_at(idx, hash, key, Value());
+        }
+        return slots_[idx].second;
+    }
+
+    // resize to hold at least new_count slots (and never below the current size)
+    void rehash(size_type new_count){
+        size_type wanted = growth_to_capacity(size_);
+        if (new_count > wanted) wanted = new_count;
+        size_type new_cap = normalize_capacity(wanted);
+        if (new_cap != capacity_) resize(new_cap);
+    }
+
+    // make room for n elements without any further resize
+    void reserve(size_type n){
+        if (n > size_ + growth_left_) {
+            resize(normalize_capacity(growth_to_capacity(n)));
+        }
+    }
+
+    void swap(MyFlatHashMap& other) noexcept {
+        mystl::swap(ctrl_, other.ctrl_);
+        mystl::swap(slots_, other.slots_);
+        mystl::swap(capacity_, other.capacity_);
+        mystl::swap(size_, other.size_);
+        mystl::swap(growth_left_, other.growth_left_);
+        mystl::swap(hasher_, other.hasher_);
+        mystl::swap(key_equal_, other.key_equal_);
+    }
+
+    void print_debug() const {
+        for (size_type i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] < 0) continue;
+            std::cout << "[" << i << "]: (" << slots_[i].first << "," << slots_[i].second << ")\n";
+        }
+    }
+
+private:
+    // ---------- hashing and probing ----------
+    size_type hash_of(const Key& key) const {
+        if constexpr (hash_is_avalanching<Hash>::value)
+            return static_cast<size_type>(hasher_(key));
+        else
+            return flat_hash_mix(static_cast<size_type>(hasher_(key)));
+    }
+
+    static size_type h1(size_type hash) noexcept {return hash >> 7;}
+    static flat_ctrl_t h2(size_type hash) noexcept {return static_cast<flat_ctrl_t>(hash & 0x7F);}
+
+    // triangular walk over groups; visits every group once when the
+    // capacity is 2^k - 1
+    struct probe_seq{
+        size_type mask;
+        size_type offset;
+        size_type index{0};
+
+        probe_seq(size_type hash, size_type m) : mask(m), offset(hash & m) {}
+
+        size_type offset_at(size_type i) const noexcept {return (offset + i) & mask;}
+
+        void next() noexcept {
+            index += group_width;
+            offset = (offset + index) & mask;
+        }
+    };
+
+    size_type find_index(const Key& key, size_type hash) const {
+        probe_seq seq(h1(hash), capacity_);
+        while (true) {
+            flat_group g(ctrl_ + seq.offset);
+            for (std::uint32_t m = g.match(h2(hash)); m; m &= m - 1) {
+                size_type idx = seq.offset_at(flat_ctz(m));
+                if (key_equal_(slots_[idx].first, key)) return idx;
+            }
+            if (g.match_empty()) return npos;
+            seq.next();
+        }
+    }
+
+    size_type find_first_non_full(size_type hash) const noexcept {
+        return find_first_non_full(ctrl_, capacity_, hash);
+    }
+
+    static size_type find_first_non_full(const flat_ctrl_t* ctrl, size_type cap, size_type hash) noexcept {
+        probe_seq seq(h1(hash), cap);
+        while (true) {
+            std::uint32_t m = flat_group(ctrl + seq.offset).match_empty_or_deleted();
+            if (m) return seq.offset_at(flat_ctz(m));
+            seq.next();
+        }
+    }
+
+    // pick the slot for a new key, growing first if no empty slot may be used
+    size_type prepare_insert(size_type hash){
+        size_type target = find_first_non_full(hash);
+        if (growth_left_ == 0 && ctrl_[target] != flat_ctrl_deleted) {
+            rehash_and_grow();
+            target = find_first_non_full(hash);
+        }
+        return target;
+    }
+
+    // build the element, then publish it in the control bytes
+    template <typename... Args>
+    void emplace_at(size_type idx, size_type hash, Args&&... args){
+        alloc_.construct(slots_ + idx, mystl::forward<Args>(args)...);
+        growth_left_ -= (ctrl_[idx] == flat_ctrl_empty) ? 1 : 0;
+        set_ctrl(idx, h2(hash));
+        ++size_;
+    }
+
+    // a slot can go straight back to empty when no probe ever had to step
+    // over it: that is, when no window of group_width bytes around it was
+    // ever completely full. Only then is a tombstone needed
+    void erase_at(size_type idx){
+        alloc_.destroy(slots_ + idx);
+        --size_;
+
+        size_type index_before = (idx - group_width) & capacity_;
+        std::uint32_t empty_after = flat_group(ctrl_ + idx).match_empty();
+        std::uint32_t empty_before = flat_group(ctrl_ + index_before).match_empty();
+        bool was_never_full = empty_before && empty_after &&
+            flat_ctz(empty_after) + (flat_clz(empty_before) - (32 - group_width)) < group_width;
+
+        set_ctrl(idx, was_never_full ? flat_ctrl_empty : flat_ctrl_deleted);
+        growth_left_ += was_never_full ? 1 : 0;
+    }
+
+    // the first group_width - 1 bytes are mirrored after the sentinel so a
+    // group load near the end of the table wraps around without a branch
+    void set_ctrl(size_type idx, flat_ctrl_t h) noexcept {
+        set_ctrl(ctrl_, capacity_, idx, h);
+    }
+
+    static void set_ctrl(flat_ctrl_t* ctrl, size_type cap, size_type idx, flat_ctrl_t h) noexcept {
+        ctrl[idx] = h;
+        ctrl[((idx - (group_width - 1)) & cap) + (group_width - 1)] = h;
+    }
+
+    // ---------- capacity ----------
+    static size_type normalize_capacity(size_type n) noexcept {
+        size_type cap = group_width - 1;
+        while (cap < n) cap = cap * 2 + 1;
+        return cap;
+    }
+
+    static size_type capacity_to_growth(size_type cap) noexcept {
+        size_type growth = cap - cap / 8;
+        return growth == cap ? cap - 1 : growth;
+    }
+
+    static size_type growth_to_capacity(size_type growth) noexcept {
+        return growth + growth / 7 + 1;
+    }
+
+    // too many tombstones: rehash into a fresh block of the same capacity,
+    // which drops them, otherwise double
+    void rehash_and_grow(){
+        if (capacity_ == 0) {
+            resize(group_width - 1);
+        } else if (size_ <= capacity_to_growth(capacity_) / 2) {
+            resize(capacity_);
+        } else {
+            resize(capacity_ * 2 + 1);
+        }
+    }
+
+    // slots and control bytes share one allocation: cap slots followed by
+    // cap + group_width control bytes
+    static size_type block_slots(size_type cap) noexcept {
+        size_type ctrl_bytes = cap + group_width;
+        return cap + (ctrl_bytes + sizeof(slot_type) - 1) / sizeof(slot_type);
+    }
+
+    void reset_ctrl() noexcept {
+        reset_ctrl(ctrl_, capacity_);
+    }
+
+    static void reset_ctrl(flat_ctrl_t* ctrl, size_type cap) noexcept {
+        std::memset(ctrl, static_cast<unsigned char>(flat_ctrl_empty), cap + group_width);
+        ctrl[cap] = flat_ctrl_sentinel;
+    }
+
+    // The new block is filled on the side and only replaces the old one
+    // once every element is in it. Elements are moved when that cannot
+    // leave the old block half-emptied (nothrow move and nothrow hash) and
+    // copied otherwise, so if a hash or a copy throws, the new block is
+    // torn down and the table is unchanged. The exception is a move-only
+    // slot whose move or hash throws: those elements may be left moved-from
+    void resize(size_type new_cap){
+        constexpr bool by_move = relocate_by_move<slot_type>::value &&
+            (std::is_nothrow_invocable<const Hash&, const Key&>::value ||
+             !std::is_copy_constructible<slot_type>::value);
+
+        slot_type* new_slots = alloc_.allocate(block_slots(new_cap));
+        flat_ctrl_t* new_ctrl = reinterpret_cast<flat_ctrl_t*>(new_slots + new_cap);
+        reset_ctrl(new_ctrl, new_cap);
+
+        try {
+            for (size_type i = 0; i < capacity_; ++i) {
+                if (ctrl_[i] < 0) continue;
+                size_type hash = hash_of(slots_[i].first);
+                size_type target = find_first_non_full(new_ctrl, new_cap, hash);
+                if constexpr (by_move) {
+                    alloc_.construct(new_slots + target, mystl::move(slots_[i]));
+                } else {
+                    alloc_.construct(new_slots + target, static_cast<const slot_type&>(slots_[i]));
+                }
+                set_ctrl(new_ctrl, new_cap, target, h2(hash));
+            }
+        } catch (...) {
+            for (size_type i = 0; i < new_cap; ++i) {
+                if (new_ctrl[i] >= 0) alloc_.destroy(new_slots + i);
+            }
+            alloc_.deallocate(new_slots, block_slots(new_cap));
+            throw;
+        }
+
+        if (capacity_) {
+            destroy_slots();
+            alloc_.deallocate(slots_, block_slots(capacity_));
+        }
+        slots_ = new_slots;
+        ctrl_ = new_ctrl;
+        capacity_ = new_cap;
+        growth_left_ = capacity_to_growth(new_cap) - size_;
+    }
+
+    void destroy_slots() noexcept {
+        for (size_type i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] >= 0) alloc_.destroy(slots_ + i);
+        }
+    }
+
+    void deallocate_storage() noexcept {
+        if (capacity_) {
+            alloc_.deallocate(slots_, block_slots(capacity_));
+        }
+        reset_to_empty();
+    }
+
+    void reset_to_empty() noexcept {
+        ctrl_ = flat_empty_group();
+        slots_ = nullptr;
+        capacity_ = 0;
+        size_ = 0;
+        growth_left_ = 0;
+    }
+};
+
+}// namespace mystl
+#endif // MY_FLAT_HASH_MAP
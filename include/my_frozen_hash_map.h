@@ -0,0 +1,369 @@
+#ifndef MY_FROZEN_HASH_MAP_H
+#define MY_FROZEN_HASH_MAP_H
+
+#include "mystl_config.h"
+#include "my_bucket_policy.h"
+#include "my_utility.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if MYSTL_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mystl{
+
+// ======================
+// frozen image layout
+// ======================
+// A frozen map is one flat block, valid at any address:
+//
+//     header | ctrl: slot_count bytes | padding | slots: slot_count x {key, value}
+//
+// ctrl[i] is 0 for an empty slot, otherwise 0x80 | the top 7 bits of the
+// key's hash, so most mismatches are rejected without touching the slot.
+// Keys are placed by linear probing from hash & (slot_count - 1). All
+// offsets are from the start of the image, so nothing needs relocating.
+// Fields are native endian, and the header records enough to refuse an
+// image built for another layout.
+struct frozen_image_header{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endian;           // 0x01020304 as written
+    std::uint32_t key_size;
+    std::uint32_t value_size;
+    std::uint32_t slot_size;
+    std::uint32_t slot_align;
+    std::uint64_t size;
+    std::uint64_t slot_count;       // a power of two
+    std::uint64_t ctrl_offset;
+    std::uint64_t slots_offset;
+    std::uint64_t total_bytes;
+    // hash of the key in slot check_slot when frozen: a reader whose Hash
+    // disagrees refuses the image instead of missing every lookup
+    std::uint64_t check_slot;
+    std::uint64_t check_hash;
+};
+
+inline constexpr char frozen_image_magic[8] = {'M', 'Y', 'S', 'T', 'L', 'F', 'H', 'M'};
+inline constexpr std::uint32_t frozen_image_version = 1;
+inline constexpr std::uint32_t frozen_image_endian = 0x01020304u;
+
+template <typename Key, typename Value>
+struct frozen_slot{
+    Key key;
+    Value value;
+};
+
+// =====================
+// Frozen Hash Map
+// =====================
+// A read-only map over a frozen image. freeze() turns any map of
+// trivially copyable keys and values (MyHashTable, MyUnorderedMap,
+// MyFlatHashMap, ...) into an image and write_file() saves it; open()
+// maps the file read-only, checks the header and is ready, so startup
+// does not depend on the size of the table. Pages are faulted in by the
+// lookups that touch them and shared between processes mapping the same
+// file.
+//
+// Hash must give the same values in the writing and the reading process:
+// mystl::hash does, std::hash on integers does in practice.
+template <
+    typename Key,
+    typename Value,
+    typename Hash = mystl::hash<Key>,
+    typename KeyEqual = mystl::equal_to<Key>>
+class MyFrozenHashMap{
+    static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value,
+                  "MyFrozenHashMap: keys and values must be trivially copyable");
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using slot_type = frozen_slot<Key, Value>;
+
+    // slots start at a multiple of this from the image start
+    static constexpr size_type image_alignment = 64;
+
+private:
+    const unsigned char* ctrl_{nullptr};
+    const slot_type* slots_{nullptr};
+    size_type mask_{0};
+    size_type size_{0};
+    Hash hasher_;
+    KeyEqual key_equal_;
+
+    // what this object must release: a mapping, or a buffer read from a file
+    void* mapping_{nullptr};
+    size_type mapping_bytes_{0};
+    unsigned char* buffer_{nullptr};
+
+public:
+    MyFrozenHashMap() = default;
+
+    // View an image already in memory, such as the result of freeze(),
+    // which must outlive the map. Throws std::invalid_argument if it is
+    // not a valid image for these types. Only the header is checked: the
+    // rest of an image is trusted, as it is read in place, though no lookup
+    // probes more than bucket_count() slots
+    MyFrozenHashMap(const void* image, size_type bytes){
+        attach(static_cast<const unsigned char*>(image), bytes);
+    }
+
+    MyFrozenHashMap(const MyFrozenHashMap&) = delete;
+    MyFrozenHashMap& operator=(const MyFrozenHashMap&) = delete;
+
+    MyFrozenHashMap(MyFrozenHashMap&& other) noexcept {swap(other);}
+
+    MyFrozenHashMap& operator=(MyFrozenHashMap&& other) noexcept {
+        MyFrozenHashMap tmp(mystl::move(other));
+        swap(tmp);
+        return *this;
+    }
+
+    ~MyFrozenHashMap(){release();}
+
+    // Map the image file read-only (or read it where there is no mmap).
+    // Throws std::runtime_error if the file cannot be opened and
+    // std::invalid_argument if it is not a valid image
+    static MyFrozenHashMap open(const char* path){
+        MyFrozenHashMap map;
+#if MYSTL_HAS_MMAP
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) throw std::runtime_error("MyFrozenHashMap: cannot open image file");
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            throw std::runtime_error("MyFrozenHashMap: cannot read image file");
+        }
+        size_type bytes = static_cast<size_type>(st.st_size);
+        void* addr = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) throw std::runtime_error("MyFrozenHashMap: cannot map image file");
+        map.mapping_ = addr;
+        map.mapping_bytes_ = bytes;
+        map.attach(static_cast<const unsigned char*>(addr), bytes);
+#else
+        std::FILE* file = std::fopen(path, "rb");
+        if (!file) throw std::runtime_error("MyFrozenHashMap: cannot open image file");
+        std::fseek(file, 0, SEEK_END);
+        long end = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        if (end <= 0) {
+            std::fclose(file);
+            throw std::runtime_error("MyFrozenHashMap: cannot read image file");
+        }
+        size_type bytes = static_cast<size_type>(end);
+        map.buffer_ = static_cast<unsigned char*>(::operator new(bytes, std::align_val_t(image_alignment)));
+        size_type got = std::fread(map.buffer_, 1, bytes, file);
+        std::fclose(file);
+        if (got != bytes) throw std::runtime_error("MyFrozenHashMap: cannot read image file");
+        map.attach(map.buffer_, bytes);
+#endif
+        return map;
+    }
+
+    // Build the image of map, whose elements have .first and .second.
+    // max_load is the slot occupancy to stay under; a lower one makes
+    // misses cheaper for a larger file
+    template <typename Map>
+    static std::vector<unsigned char> freeze(const Map& map, float max_load = 0.7f){
+        if (!(max_load > 0.0f && max_load < 1.0f))
+            throw std::invalid_argument("MyFrozenHashMap: max_load must be in (0, 1)");
+
+        size_type n = static_cast<size_type>(map.size());
+        size_type wanted = static_cast<size_type>(static_cast<float>(n) / max_load) + 1;
+        size_type slot_count = 8;
+        while (slot_count < wanted) slot_count <<= 1;
+
+        frozen_image_header header{};
+        std::memcpy(header.magic, frozen_image_magic, sizeof(header.magic));
+        header.version = frozen_image_version;
+        header.endian = frozen_image_endian;
+        header.key_size = static_cast<std::uint32_t>(sizeof(Key));
+        header.value_size = static_cast<std::uint32_t>(sizeof(Value));
+        header.slot_size = static_cast<std::uint32_t>(sizeof(slot_type));
+        header.slot_align = static_cast<std::uint32_t>(alignof(slot_type));
+        header.slot_count = slot_count;
+        header.ctrl_offset = sizeof(frozen_image_header);
+        header.slots_offset = align_up(header.ctrl_offset + slot_count, image_alignment);
+        header.total_bytes = header.slots_offset + slot_count * sizeof(slot_type);
+
+        // zero-filled, so empty slots and padding are deterministic
+        std::vector<unsigned char> image(static_cast<size_type>(header.total_bytes), 0);
+        unsigned char* ctrl = image.data() + header.ctrl_offset;
+        unsigned char* slots = image.data() + header.slots_offset;
+
+        Hash hasher;
+        KeyEqual equal;
+        size_type mask = slot_count - 1;
+        size_type size = 0;
+        bool have_check = false;
+        for (const auto& kv : map) {
+            std::uint64_t hash = hash_of(hasher, kv.first);
+            size_type idx = static_cast<size_type>(hash) & mask;
+            bool duplicate = false;
+            while (ctrl[idx]) {
+                const slot_type* slot = reinterpret_cast<const slot_type*>(slots + idx * sizeof(slot_type));
+                if (equal(slot->key, kv.first)) {
+                    duplicate = true;
+                    break;
+                }
+                idx = (idx + 1) & mask;
+            }
+            if (duplicate) continue;
+            ctrl[idx] = tag_of(hash);
+            ::new (static_cast<void*>(slots + idx * sizeof(slot_type))) slot_type{kv.first, kv.second};
+            ++size;
+            if (!have_check) {
+                header.check_slot = idx;
+                header.check_hash = hash;
+                have_check = true;
+            }
+        }
+        header.size = size;
+        std::memcpy(image.data(), &header, sizeof(header));
+        return image;
+    }
+
+    // freeze map into the file at path, replacing it. Throws
+    // std::runtime_error if the file cannot be written
+    template <typename Map>
+    static void write_file(const Map& map, const char* path, float max_load = 0.7f){
+        std::vector<unsigned char> image = freeze(map, max_load);
+        std::FILE* file = std::fopen(path, "wb");
+        if (!file) throw std::runtime_error("MyFrozenHashMap: cannot create image file");
+        size_type written = std::fwrite(image.data(), 1, image.size(), file);
+        int closed = std::fclose(file);
+        if (written != image.size() || closed != 0)
+            throw std::runtime_error("MyFrozenHashMap: cannot write image file");
+    }
+
+    bool empty() const noexcept {return size_ == 0;}
+    size_type size() const noexcept {return size_;}
+    size_type bucket_count() const noexcept {return slots_ ? mask_ + 1 : 0;}
+
+    const Value* find(const Key& key) const {
+        if (!slots_) return nullptr;
+        std::uint64_t hash = hash_of(hasher_, key);
+        unsigned char tag = tag_of(hash);
+        // a well-formed image always has an empty slot to stop at; the cap
+        // keeps a damaged one from probing forever
+        size_type idx = static_cast<size_type>(hash) & mask_;
+        for (size_type step = 0; step <= mask_; ++step, idx = (idx + 1) & mask_) {
+            unsigned char c = ctrl_[idx];
+            if (c == 0) return nullptr;
+            if (c == tag && key_equal_(slots_[idx].key, key)) return &slots_[idx].value;
+        }
+        return nullptr;
+    }
+
+    bool contains(const Key& key) const {return find(key) != nullptr;}
+
+    size_type count(const Key& key) const {return contains(key) ? 1 : 0;}
+
+    // call f(key, value) for every element, in slot order
+    template <typename F>
+    void for_each(F&& f) const {
+        for (size_type i = 0; i < bucket_count(); ++i) {
+            if (ctrl_[i]) f(slots_[i].key, slots_[i].value);
+        }
+    }
+
+    void swap(MyFrozenHashMap& other) noexcept {
+        mystl::swap(ctrl_, other.ctrl_);
+        mystl::swap(slots_, other.slots_);
+        mystl::swap(mask_, other.mask_);
+        mystl::swap(size_, other.size_);
+        mystl::swap(hasher_, other.hasher_);
+        mystl::swap(key_equal_, other.key_equal_);
+        mystl::swap(mapping_, other.mapping_);
+        mystl::swap(mapping_bytes_, other.mapping_bytes_);
+        mystl::swap(buffer_, other.buffer_);
+    }
+
+private:
+    static std::uint64_t align_up(std::uint64_t n, std::uint64_t a) noexcept {
+        return (n + a - 1) / a * a;
+    }
+
+    static std::uint64_t hash_of(const Hash& hasher, const Key& key){
+        std::uint64_t h = static_cast<std::uint64_t>(hasher(key));
+        if constexpr (!hash_is_avalanching<Hash>::value) h = bucket_mix(h);
+        return h;
+    }
+
+    static unsigned char tag_of(std::uint64_t hash) noexcept {
+        return static_cast<unsigned char>(0x80u | (hash >> 57));
+    }
+
+    // check the header against these types and the bytes at hand, then
+    // point into the image
+    void attach(const unsigned char* image, size_type bytes){
+        auto invalid = []{
+            throw std::invalid_argument("MyFrozenHashMap: not a valid image for these key and value types");
+        };
+        frozen_image_header header;
+        if (!image || bytes < sizeof(header)) invalid();
+        if (reinterpret_cast<std::uintptr_t>(image) % alignof(slot_type) != 0)
+            throw std::invalid_argument("MyFrozenHashMap: image is not aligned for its slots");
+        std::memcpy(&header, image, sizeof(header));
+        if (std::memcmp(header.magic, frozen_image_magic, sizeof(header.magic)) != 0 ||
+            header.version != frozen_image_version || header.endian != frozen_image_endian ||
+            header.key_size != sizeof(Key) || header.value_size != sizeof(Value) ||
+            header.slot_size != sizeof(slot_type) || header.slot_align != alignof(slot_type))
+            invalid();
+        // offsets and sizes come from the file: compare by subtraction and
+        // division so a huge slot_count cannot wrap past the checks
+        std::uint64_t slot_count = header.slot_count;
+        if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0 || header.size >= slot_count ||
+            header.total_bytes > bytes || header.ctrl_offset < sizeof(header) ||
+            header.ctrl_offset > header.slots_offset ||
+            slot_count > header.slots_offset - header.ctrl_offset ||
+            header.slots_offset % alignof(slot_type) != 0 ||
+            header.slots_offset > header.total_bytes ||
+            slot_count > (header.total_bytes - header.slots_offset) / sizeof(slot_type))
+            invalid();
+
+        ctrl_ = image + header.ctrl_offset;
+        slots_ = reinterpret_cast<const slot_type*>(image + header.slots_offset);
+        mask_ = static_cast<size_type>(slot_count - 1);
+        size_ = static_cast<size_type>(header.size);
+
+        if (size_ && (header.check_slot >= slot_count || !ctrl_[header.check_slot] ||
+                      hash_of(hasher_, slots_[header.check_slot].key) != header.check_hash)) {
+            ctrl_ = nullptr;
+            slots_ = nullptr;
+            throw std::invalid_argument("MyFrozenHashMap: image was built with a different hash");
+        }
+    }
+
+    void release() noexcept {
+#if MYSTL_HAS_MMAP
+        if (mapping_) ::munmap(mapping_, mapping_bytes_);
+#endif
+        if (buffer_) ::operator delete(buffer_, std::align_val_t(image_alignment));
+        mapping_ = nullptr;
+        buffer_ = nullptr;
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+        mask_ = size_ = 0;
+    }
+};
+
+} // namespace mystl
+
+#endif // MY_FROZEN_HASH_MAP_H
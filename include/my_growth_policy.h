@@ -0,0 +1,39 @@
+#ifndef MY_GROWTH_POLICY_H
+#define MY_GROWTH_POLICY_H
+
+#include <cstddef>
+
+namespace mystl{
+
+// ===============================
+// vector growth policies
+// ===============================
+// A growth policy decides the next capacity of MyVector / MySmallVector when
+// it runs out of room. It is any class with
+//
+//     static std::size_t grow(std::size_t capacity, std::size_t required);
+//
+// returning a capacity of at least `required`. The allocator may still hand
+// back a slightly larger block, which the vector keeps as extra capacity.
+
+// double the capacity: fewest reallocations, up to 50% slack
+struct growth_2x {
+    static std::size_t grow(std::size_t capacity, std::size_t required) noexcept {
+        std::size_t next = capacity == 0 ? 1 : capacity * 2;
+        return next < required ? required : next;
+    }
+};
+
+// grow by half: about 25% slack on average, and freed blocks can be
+// reused by later growth steps
+struct growth_1_5x {
+    static std::size_t grow(std::size_t capacity, std::size_t required) noexcept {
+        std::size_t next = capacity + capacity / 2;
+        if (next == capacity) ++next;
+        return next < required ? required : next;
+    }
+};
+
+} // namespace mystl
+
+#endif // MY_GROWTH_POLICY_H
@@ -1,40 +1,299 @@
 #ifndef MY_HASH_TABLE
 #define MY_HASH_TABLE
 
+#include "mystl_config.h"
 #include "my_allocator.h"
+#include "my_bucket_policy.h"
 #include "my_iterator.h"
 #include "my_utility.h"
 #include "my_vector.h"
 
 #include <vector>
+#include <atomic>
 #include <functional>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 
 namespace mystl{
 
 // ======================
 // Hash Node
 // ======================
-template <typename Key, typename Value>
-struct hash_node{
+// Whether hash_node<Key, ...> keeps its key's hash. A stored hash lets
+// rehash skip the hasher and lets lookups reject most chain nodes without
+// calling KeyEqual. It is on for keys that are costly to hash or compare
+// (strings, aggregates) and off for scalars, where it would only widen the
+// node; specialize it to choose for a key type.
+template <typename Key>
+struct hash_node_stores_hash
+    : std::integral_constant<bool, !std::is_arithmetic<Key>::value &&
+                                   !std::is_enum<Key>::value &&
+                                   !std::is_pointer<Key>::value> {};
+
+template <bool StoreHash>
+struct hash_node_hash{
+    static constexpr bool stores_hash = false;
+    void set_hash(std::size_t) noexcept {}
+};
+
+template <>
+struct hash_node_hash<true>{
+    static constexpr bool stores_hash = true;
+    std::size_t hash{0};
+    void set_hash(std::size_t h) noexcept {hash = h;}
+};
+
+template <typename Key, typename Value, bool StoreHash = hash_node_stores_hash<Key>::value>
+struct hash_node : hash_node_hash<StoreHash>{
     mystl::pair<Key, Value> data;
     hash_node* next{nullptr};
 
-    hash_node(const Key& k, const Value& v, hash_node* n = nullptr)
-        : data(k, v), next(n) {}
+    // args build data: (key, value), or piecewise_construct and two tuples
+    template <typename... Args>
+    explicit hash_node(hash_node* n, Args&&... args)
+        : data(mystl::forward<Args>(args)...), next(n) {}
+};
+
+// ======================
+// bucket array
+// ======================
+inline unsigned bucket_ctz(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned n = 0;
+    while (!(x & 1u)) { x >>= 1; ++n; }
+    return n;
+#endif
+}
+
+// bucket heads plus one occupancy bit per bucket, so clear() and the
+// iterators jump from one non-empty bucket to the next without reading the
+// empty ones. Writers keep the bits in step through link / set_head / take
+template <typename Node>
+struct hash_bucket_array{
+    mystl::MyVector<Node*> heads;
+    mystl::MyVector<std::uint64_t> used;
+
+    hash_bucket_array() = default;
+
+    explicit hash_bucket_array(std::size_t n)
+        : heads(n, nullptr), used((n + 63) / 64, std::uint64_t(0)) {}
+
+    std::size_t size() const noexcept {return heads.size();}
+    bool empty() const noexcept {return heads.empty();}
+
+    Node* operator[](std::size_t i) const noexcept {return heads[i];}
+    Node* const* slot(std::size_t i) const noexcept {return &heads[i];}
+
+    void link(std::size_t i, Node* node) noexcept {
+        node->next = heads[i];
+        heads[i] = node;
+        used[i >> 6] |= std::uint64_t(1) << (i & 63);
+    }
+
+    // make head, with the chain behind it, bucket i's chain
+    void set_head(std::size_t i, Node* head) noexcept {
+        heads[i] = head;
+        if(head) used[i >> 6] |= std::uint64_t(1) << (i & 63);
+        else used[i >> 6] &= ~(std::uint64_t(1) << (i & 63));
+    }
+
+    // first non-empty bucket at or after i, or size()
+    std::size_t next_used(std::size_t i) const noexcept {
+        std::size_t n = heads.size();
+        if(i >= n) return n;
+        std::size_t w = i >> 6;
+        std::uint64_t bits = used[w] & (~std::uint64_t(0) << (i & 63));
+        while(!bits){
+            if(++w == used.size()) return n;
+            bits = used[w];
+        }
+        return (w << 6) + bucket_ctz(bits);
+    }
+
+    // detach bucket i's chain and return it
+    Node* take(std::size_t i) noexcept {
+        Node* head = heads[i];
+        heads[i] = nullptr;
+        used[i >> 6] &= ~(std::uint64_t(1) << (i & 63));
+        return head;
+    }
+
+    void swap(hash_bucket_array& other) noexcept {
+        heads.swap(other.heads);
+        used.swap(other.used);
+    }
+
+    std::size_t bytes() const noexcept {
+        return heads.capacity() * sizeof(Node*) + used.capacity() * sizeof(std::uint64_t);
+    }
+};
+
+// ======================
+// hash table statistics
+// ======================
+// What MyHashTable::stats() returns. The shape of the table is measured
+// when stats() is called; the operation counters at the end are kept only
+// when MYSTL_HASHTABLE_STATS is 1 and read zero otherwise. During an
+// incremental rehash both bucket arrays are counted together.
+struct hash_table_stats{
+    static constexpr std::size_t histogram_bins = 8;
+
+    std::size_t size{0};
+    std::size_t bucket_count{0};
+    std::size_t used_buckets{0};
+    // [k]: buckets holding k elements; the last bin counts longer chains too
+    std::size_t chain_length_histogram[histogram_bins]{};
+    std::size_t max_chain_length{0};
+    double mean_chain_length{0};            // over the non-empty buckets
+    double load_factor{0};
+
+    // share of elements that are not alone in their bucket, against what a
+    // uniformly random hash would give at this load; a much higher figure
+    // means the hash (or the bucket policy) leaves bits unused
+    double bucket_collision_rate{0};
+    double expected_bucket_collision_rate{0};
+
+    // elements whose full hash equals that of an earlier, different key in
+    // the same chain: the hash function itself cannot tell them apart
+    std::size_t hash_collisions{0};
+    double hash_collision_rate{0};
+
+    std::size_t bytes_allocated{0};         // nodes plus bucket arrays
+
+    // MYSTL_HASHTABLE_STATS only
+    std::size_t rehash_count{0};            // synchronous and incremental
+    std::size_t lookups{0};                 // find/insert/contains probes
+    std::size_t probes{0};                  // nodes compared by those
+    std::size_t max_probe_length{0};
+    double mean_probe_length{0};
+};
+
+// ======================
+// hash table iterator
+// ======================
+// Walks the table's buckets in order. During an incremental rehash the
+// buckets are the old array followed by the new one, and the find, insert
+// and erase calls that migrate buckets invalidate iterators.
+template <typename Table, typename Value>
+class hash_table_iterator{
+public:
+    using iterator_category = mystl::forward_iterator_tag;
+    using value_type = typename std::remove_const<Value>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+private:
+    using node_type = typename Table::node_type;
+    using size_type = typename Table::size_type;
+
+    template <typename, typename> friend class hash_table_iterator;
+    friend Table;
+
+    const Table* table_{nullptr};
+    node_type* node_{nullptr};
+    size_type bucket_{0};
+
+public:
+    hash_table_iterator() = default;
+
+    hash_table_iterator(const Table* table, node_type* node, size_type bucket)
+        : table_(table), node_(node), bucket_(bucket) {}
+
+    // iterator -> const_iterator
+    template <typename V, typename = std::enable_if_t<std::is_same<const V, Value>::value &&
+                                                      !std::is_same<V, Value>::value>>
+    hash_table_iterator(const hash_table_iterator<Table, V>& other)
+        : table_(other.table_), node_(other.node_), bucket_(other.bucket_) {}
+
+    reference operator*() const {return node_->data;}
+    pointer operator->() const {return &node_->data;}
+
+    hash_table_iterator& operator++(){
+        node_ = node_->next;
+        if(!node_) node_ = table_->next_bucket_head(bucket_);
+        return *this;
+    }
+
+    hash_table_iterator operator++(int){
+        hash_table_iterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const hash_table_iterator& other) const {return node_ == other.node_;}
+    bool operator!=(const hash_table_iterator& other) const {return node_ != other.node_;}
+};
+
+// ======================
+// bulk build helpers
+// ======================
+// which of several equal keys MyHashTable::build keeps; keys already in
+// the table count as coming first
+enum class duplicate_policy{
+    first_wins,
+    last_wins
 };
 
+namespace detail{
+
+// threads == 0 means one per hardware thread; small jobs stay on the
+// calling thread
+inline unsigned build_threads(unsigned threads, std::size_t work, std::size_t min_work) noexcept {
+    if(threads == 0) threads = std::thread::hardware_concurrency();
+    if(threads == 0) threads = 1;
+    std::size_t useful = work / min_work;
+    if(useful < threads) threads = useful ? static_cast<unsigned>(useful) : 1u;
+    return threads;
+}
+
+// split [0, n) into `threads` contiguous chunks and run f(begin, end) on
+// each, the first on the calling thread; rethrows the first exception
+template <typename F>
+void parallel_for(unsigned threads, std::size_t n, F f){
+    if(threads <= 1){
+        f(std::size_t(0), n);
+        return;
+    }
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    auto chunk = [&](unsigned t){
+        try{
+            f(n * t / threads, n * (t + 1) / threads);
+        }catch(...){
+            errors[t] = std::current_exception();
+        }
+    };
+    for(unsigned t = 1; t < threads; ++t) workers.emplace_back(chunk, t);
+    chunk(0);
+    for(std::thread& w : workers) w.join();
+    for(std::exception_ptr& e : errors){
+        if(e) std::rethrow_exception(e);
+    }
+}
+
+} // namespace detail
+
 // =====================
 // Hash Table
 // =====================
 template <
     typename Key,
     typename Value,
-    //TODO: replace this hash
-    typename Hash = std::hash<Key>,
+    typename Hash = mystl::hash<Key>,
     typename KeyEqual = mystl::equal_to<Key>,
-    typename Alloc = mystl::MyAllocator<hash_node<Key, Value>>>
+    typename Alloc = mystl::MyAllocator<hash_node<Key, Value>>,
+    typename BucketPolicy = mystl::pow2_bucket_policy>
 class MyHashTable{
 public:
     using key_type = Key;
@@ -43,93 +302,727 @@ public:
     using size_type = std::size_t;
     using node_type = hash_node<Key, Value>;
     using allocator_type = Alloc;
+    using bucket_policy = BucketPolicy;
+    using iterator = hash_table_iterator<MyHashTable, value_type>;
+    using const_iterator = hash_table_iterator<MyHashTable, const value_type>;
 
 private:
-    mystl::MyVector<node_type*> buckets_;
+    using bucket_array = hash_bucket_array<node_type>;
+
+    bucket_array buckets_;
+    bucket_policy policy_;
     size_type size_{0};
     float max_load_factor_{0.75f};
     Hash hasher_;
     KeyEqual key_equal_;
     allocator_type alloc_;
 
+    // incremental rehash, in the style of Redis dict: while new_buckets_ is
+    // non-empty the table is migrating from buckets_ into it, and every
+    // buckets_[i] with i < rehash_pos_ has already been moved
+    bool incremental_{false};
+    bucket_array new_buckets_;
+    bucket_policy new_policy_;
+    size_type rehash_pos_{0};
+
+    // non-empty buckets migrated per operation; the occupancy bits let
+    // the migration jump over empty ones
+    static constexpr size_type rehash_step = 4;
+
+    // how far ahead the batched lookups prefetch: enough misses in flight
+    // to cover memory latency, few enough to keep the state on the stack
+    static constexpr size_type batch_distance = 8;
+
+    // below this many elements per thread, build() does not split its work
+    static constexpr size_type build_min_chunk = size_type(1) << 15;
+
+#if MYSTL_HASHTABLE_STATS
+    // const lookups may run on many threads at once (MyConcurrentHashMap's
+    // shared reads), so their counters are relaxed atomics
+    mutable std::atomic<size_type> stat_lookups_{0};
+    mutable std::atomic<size_type> stat_probes_{0};
+    mutable std::atomic<size_type> stat_max_probe_{0};
+    size_type stat_rehashes_{0};
+#endif
+
+    template <typename K>
+    using enable_if_transparent =
+        std::enable_if_t<mystl::transparent_lookup<K, Hash, KeyEqual>::value, int>;
+
+    template <typename, typename> friend class hash_table_iterator;
+
 public:
     MyHashTable(size_type bucket_count = 8)
-        : buckets_(bucket_count, nullptr), size_(0) {}
+        : buckets_(bucket_policy::bucket_count_for(bucket_count)), size_(0) {
+        policy_.reset(bucket_policy::bucket_count_for(bucket_count));
+    }
     
+    // the copy takes other's bucket count and keeps each node's hash, so
+    // no key is rehashed; a migration in progress is not carried over
+    MyHashTable(const MyHashTable& other)
+        : buckets_(other.bucket_count()),
+          policy_(other.rehashing() ? other.new_policy_ : other.policy_),
+          max_load_factor_(other.max_load_factor_),
+          hasher_(other.hasher_), key_equal_(other.key_equal_), alloc_(other.alloc_),
+          incremental_(other.incremental_) {
+        try{
+            copy_nodes(other.buckets_, other);
+            copy_nodes(other.new_buckets_, other);
+        }catch(...){
+            clear();
+            throw;
+        }
+    }
+
+    // steals other's nodes and bucket arrays; other is left empty with
+    // the default bucket count, which is the one allocation made here
+    MyHashTable(MyHashTable&& other) : MyHashTable() {
+        swap(other);
+    }
+
+    MyHashTable& operator=(const MyHashTable& other){
+        if(this != &other){
+            MyHashTable copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    // other gets this table's buckets back, emptied
+    MyHashTable& operator=(MyHashTable&& other) noexcept {
+        if(this != &other){
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+
     ~MyHashTable(){
         clear();
     }
 
+    // the statistics stay with each table
+    void swap(MyHashTable& other) noexcept {
+        buckets_.swap(other.buckets_);
+        mystl::swap(policy_, other.policy_);
+        mystl::swap(size_, other.size_);
+        mystl::swap(max_load_factor_, other.max_load_factor_);
+        mystl::swap(hasher_, other.hasher_);
+        mystl::swap(key_equal_, other.key_equal_);
+        mystl::swap(alloc_, other.alloc_);
+        mystl::swap(incremental_, other.incremental_);
+        new_buckets_.swap(other.new_buckets_);
+        mystl::swap(new_policy_, other.new_policy_);
+        mystl::swap(rehash_pos_, other.rehash_pos_);
+    }
+
     bool empty() const noexcept {return size_ ==0;}
 
     size_type size() const noexcept { return size_;}
-    size_type bucket_count() const noexcept {return buckets_.size();}
 
-    void clear(){
-        for(auto& head : buckets_){
-            while(head){
+    // while migrating, the count being migrated to
+    size_type bucket_count() const noexcept {
+        return rehashing() ? new_buckets_.size() : buckets_.size();
+    }
 
-            }
-        }
+    // grow by migrating a few buckets per insert/find/erase instead of all
+    // at once when the load factor is exceeded
+    void set_incremental_rehash(bool on) noexcept {incremental_ = on;}
+    bool incremental_rehash() const noexcept {return incremental_;}
+
+    bool rehashing() const noexcept {return !new_buckets_.empty();}
+
+    iterator begin() noexcept {return first_iterator<iterator>();}
+    iterator end() noexcept {return iterator();}
+    const_iterator begin() const noexcept {return first_iterator<const_iterator>();}
+    const_iterator end() const noexcept {return const_iterator();}
+    const_iterator cbegin() const noexcept {return begin();}
+    const_iterator cend() const noexcept {return end();}
+
+    // Visits only the non-empty buckets, found through the occupancy bits,
+    // and stops once size() nodes are freed
+    void clear(){
+        size_type remaining = free_nodes(buckets_, size_);
+        free_nodes(new_buckets_, remaining);
+        if(rehashing()) finish_rehash();
+        size_ = 0;
     }
 
+    // new_count is rounded up to a count the bucket policy can index.
+    // Always synchronous; a migration in progress is completed first
     void rehash(size_type new_count){
-        mystl::MyVector<node_type*> new_buckets(new_count, nullptr);
-
-        for(auto& head : buckets_){
-            while(head){
-                node_type* next = head->next;
-                size_t index = hasher_(head->data.first) % new_count;
-                head->next = new_buckets[index];
-                new_buckets[index] = head;
-                head = next;
+        if(rehashing()) migrate_buckets(buckets_.size());
+        note_rehash();
+
+        new_count = bucket_policy::bucket_count_for(new_count);
+        bucket_array new_buckets(new_count);
+        bucket_policy new_policy(policy_);
+        new_policy.reset(new_count);
+
+        for(size_type i = buckets_.next_used(0); i < buckets_.size(); i = buckets_.next_used(i + 1)){
+            node_type* node = buckets_.take(i);
+            while(node){
+                node_type* next = node->next;
+                new_buckets.link(new_policy.index(node_hash(node)), node);
+                node = next;
             }
         }
         buckets_.swap(new_buckets);
+        policy_ = new_policy;
+    }
+
+    // size the buckets once so that n elements fit without a rehash
+    void reserve(size_type n){
+        size_type needed = static_cast<size_type>(static_cast<float>(n) / max_load_factor_) + 1;
+        if(needed > bucket_count()) rehash(needed);
     }
 
     float load_factor() const noexcept{
-        return static_cast<float>(size_) / static_cast<float>(buckets_.size());
+        return static_cast<float>(size_) / static_cast<float>(bucket_count());
     }
 
+    float max_load_factor() const noexcept {return max_load_factor_;}
+
+    // rehashes right away if the table is already above the new limit
+    void max_load_factor(float ml){
+        if(!(ml > 0.0f)) throw std::invalid_argument("MyHashTable: max_load_factor must be positive");
+        max_load_factor_ = ml;
+        if(load_factor() > max_load_factor_) reserve(size_);
+    }
+
+    // insert or overwrite
     void insert(const Key& key, const Value& value){
-        if(load_factor() > max_load_factor_){
-            rehash(buckets_.size() * 2);
+        insert_or_assign(key, value);
+    }
+
+    // The insert family below hashes the key once and walks its chain once;
+    // a miss links a node built in place from the forwarded arguments.
+
+    // build the mapped value from args only if key is absent
+    template <typename... Args>
+    mystl::pair<iterator, bool> try_emplace(const Key& key, Args&&... args){
+        return emplace_key(hash_of(key), key, mystl::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    mystl::pair<iterator, bool> try_emplace(Key&& key, Args&&... args){
+        return emplace_key(hash_of(key), mystl::move(key), mystl::forward<Args>(args)...);
+    }
+
+    // assign obj to the mapped value, or insert it if key is absent;
+    // .second is true for an insert
+    template <typename M>
+    mystl::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj){
+        return assign_key(hash_of(key), key, mystl::forward<M>(obj));
+    }
+
+    template <typename M>
+    mystl::pair<iterator, bool> insert_or_assign(Key&& key, M&& obj){
+        return assign_key(hash_of(key), mystl::move(key), mystl::forward<M>(obj));
+    }
+
+    // args build a value_type; the node is built first to learn its key
+    // and discarded if the key is already present
+    template <typename... Args>
+    mystl::pair<iterator, bool> emplace(Args&&... args){
+        prepare_insert();
+        node_type* node = create_node(mystl::forward<Args>(args)...);
+        size_type hash = hash_of(node->data.first);
+        size_type bucket;
+        if(node_type* found = find_node(node->data.first, hash, &bucket)){
+            alloc_.destroy(node);
+            alloc_.deallocate(node, 1);
+            return {iterator(this, found, bucket), false};
         }
+        return {link_node(node, hash), true};
+    }
 
-        size_t idx = hasher_(key) % buckets_.size();
-        node_type* head = buckets_[idx];
+    Value* find(const Key& key){return find_value(key, hash_of(key));}
 
-        for(node_type* node = head; node; node = node->next){
-            if(key_equal_(node->data.first, key)){
-                node->data.second = value;
-                return;
-            }
+    // never advances an incremental rehash, so readers sharing a lock may
+    // call it concurrently
+    const Value* find(const Key& key) const {return find_const(key, hash_of(key));}
+
+    bool erase(const Key& key){return erase_key(key, hash_of(key));}
+
+    // erase the element at pos and return the one after it. Does not
+    // advance an incremental rehash, so other iterators stay valid
+    iterator erase(const_iterator pos){
+        const_iterator next = pos;
+        ++next;
+        node_type* target = pos.node_;
+        bucket_array& array = pos.bucket_ < buckets_.size() ? buckets_ : new_buckets_;
+        size_type idx = pos.bucket_ < buckets_.size() ? pos.bucket_ : pos.bucket_ - buckets_.size();
+        node_type* head = array[idx];
+        if(head == target){
+            array.set_head(idx, target->next);
+        }else{
+            node_type* prev = head;
+            while(prev->next != target) prev = prev->next;
+            prev->next = target->next;
         }
+        alloc_.destroy(target);
+        alloc_.deallocate(target, 1);
+        --size_;
+        return iterator(this, next.node_, next.bucket_);
+    }
+
+    iterator erase(iterator pos){return erase(const_iterator(pos));}
+
+    bool contains(const Key& key) const {return find_node(key, hash_of(key)) != nullptr;}
+
+    size_type count(const Key& key) const {return contains(key) ? 1 : 0;}
+
+    // Heterogeneous lookup: when both Hash and KeyEqual declare
+    // is_transparent, any K they accept can be looked up without building
+    // a Key, e.g. a std::string_view or const char* in a std::string table.
+    // Hash must give a K the same hash as the equal Key.
+    template <typename K, enable_if_transparent<K> = 0>
+    Value* find(const K& key){return find_value(key, hash_of(key));}
+
+    template <typename K, enable_if_transparent<K> = 0>
+    const Value* find(const K& key) const {return find_const(key, hash_of(key));}
+
+    template <typename K, enable_if_transparent<K> = 0>
+    bool erase(const K& key){return erase_key(key, hash_of(key));}
+
+    template <typename K, enable_if_transparent<K> = 0>
+    bool contains(const K& key) const {return find_node(key, hash_of(key)) != nullptr;}
+
+    template <typename K, enable_if_transparent<K> = 0>
+    size_type count(const K& key) const {return contains(key) ? 1 : 0;}
+
+    // Prehashed operations, for a caller that needs the key's hash anyway
+    // (MyConcurrentHashMap picks a shard from it): hash must be
+    // hash_value(key), and the table then does not hash the key again
+    size_type hash_value(const Key& key) const {return hash_of(key);}
+
+    Value* find_hashed(const Key& key, size_type hash){return find_value(key, hash);}
+
+    const Value* find_hashed(const Key& key, size_type hash) const {return find_const(key, hash);}
+
+    bool contains_hashed(const Key& key, size_type hash) const {return find_node(key, hash) != nullptr;}
+
+    template <typename... Args>
+    mystl::pair<iterator, bool> try_emplace_hashed(const Key& key, size_type hash, Args&&... args){
+        return emplace_key(hash, key, mystl::forward<Args>(args)...);
+    }
 
-        node_type* new_node = alloc_.allocate(1);
-        alloc_.construct(new_node, key, value, head);
-        buckets_[idx] = new_node;
+    template <typename M>
+    mystl::pair<iterator, bool> insert_or_assign_hashed(const Key& key, size_type hash, M&& obj){
+        return assign_key(hash, key, mystl::forward<M>(obj));
+    }
+
+    bool erase_hashed(const Key& key, size_type hash){return erase_key(key, hash);}
+
+    // Look up keys[0..n) and store a pointer to each value, or nullptr, in
+    // out[i]. Buckets and first nodes are prefetched several keys ahead of
+    // the one being resolved, so the cache misses of consecutive keys
+    // overlap instead of being taken one after another.
+    void find_batch(const Key* keys, size_type n, Value** out){
+        if(rehashing()) migrate_buckets(rehash_step);
+        lookup_batch(keys, n, [out](size_type i, node_type* node){
+            out[i] = node ? &node->data.second : nullptr;
+        });
+    }
+
+    void contains_batch(const Key* keys, size_type n, bool* out) const {
+        lookup_batch(keys, n, [out](size_type i, node_type* node){
+            out[i] = node != nullptr;
+        });
+    }
+
+    // Insert [first, last), whose elements have .first and .second, in bulk;
+    // returns how many keys were new. The buckets are sized once up front,
+    // keys are hashed on `threads` threads (0: one per hardware thread),
+    // then radix-partitioned by bucket so that each partition links into
+    // its own contiguous run of buckets, in input order so the duplicate
+    // policy holds. Partitions are linked in parallel too when the
+    // allocator is stateless (malloc-backed); a stateful one such as
+    // MyNodePool allocates from the calling thread only. Needs about
+    // 16 bytes per element of scratch, 24 for non random-access ranges.
+    // If an element's construction throws, the elements linked so far
+    // stay in the table.
+    template <typename ForwardIt>
+    size_type build(ForwardIt first, ForwardIt last,
+                    duplicate_policy policy = duplicate_policy::last_wins, unsigned threads = 0){
+        static_assert(mystl::is_forward_iterator<ForwardIt>::value,
+                      "MyHashTable::build needs forward iterators");
+        constexpr bool random_access = mystl::is_random_access_iterator<ForwardIt>::value;
+
+        size_type n = static_cast<size_type>(mystl::distance(first, last));
+        if(n == 0) return 0;
+
+        // one resize for the whole range, and no migration left to interleave
+        size_type needed = static_cast<size_type>(static_cast<float>(size_ + n) / max_load_factor_) + 1;
+        if(needed > bucket_count()) rehash(needed);
+        else if(rehashing()) migrate_buckets(buckets_.size());
+
+        std::vector<ForwardIt> items;
+        if constexpr (!random_access){
+            items.reserve(n);
+            for(ForwardIt it = first; it != last; ++it) items.push_back(it);
+        }
+        auto element = [&](size_type i) -> decltype(*first) {
+            if constexpr (random_access) return first[static_cast<std::ptrdiff_t>(i)];
+            else return *items[i];
+        };
+
+        unsigned hash_threads = detail::build_threads(threads, n, build_min_chunk);
+        std::vector<size_type> hashes(n);
+        detail::parallel_for(hash_threads, n, [&](size_type begin, size_type end){
+            for(size_type i = begin; i < end; ++i) hashes[i] = hash_of(element(i).first);
+        });
+
+        // partitions span a multiple of 64 buckets, so two never share a
+        // word of the occupancy bitmap
+        size_type bucket_total = buckets_.size();
+        size_type per_part = (bucket_total / 1024 + 63) / 64 * 64;
+        if(per_part == 0) per_part = 64;
+        size_type parts = (bucket_total + per_part - 1) / per_part;
+
+        std::vector<size_type> starts(parts + 1, 0);
+        for(size_type i = 0; i < n; ++i) ++starts[policy_.index(hashes[i]) / per_part + 1];
+        for(size_type p = 0; p < parts; ++p) starts[p + 1] += starts[p];
+        std::vector<size_type> order(n);
+        {
+            std::vector<size_type> fill(starts.begin(), starts.end() - 1);
+            for(size_type i = 0; i < n; ++i) order[fill[policy_.index(hashes[i]) / per_part]++] = i;
+        }
+
+        unsigned link_threads = std::is_empty<allocator_type>::value ? hash_threads : 1u;
+        if(link_threads > parts) link_threads = static_cast<unsigned>(parts);
+        std::vector<size_type> added(parts, 0);
+        std::exception_ptr error;
+        try{
+            detail::parallel_for(link_threads, parts, [&](size_type part_begin, size_type part_end){
+                for(size_type p = part_begin; p < part_end; ++p){
+                    for(size_type k = starts[p]; k < starts[p + 1]; ++k){
+                        size_type i = order[k];
+                        size_type hash = hashes[i];
+                        size_type idx = policy_.index(hash);
+                        decltype(auto) item = element(i);
+                        node_type* found = buckets_[idx];
+                        while(found && !key_matches(found, item.first, hash)) found = found->next;
+                        if(found){
+                            if(policy == duplicate_policy::last_wins)
+                                found->data.second = mystl::forward<decltype(item)>(item).second;
+                            continue;
+                        }
+                        node_type* node = create_node(mystl::forward<decltype(item)>(item).first,
+                                                      mystl::forward<decltype(item)>(item).second);
+                        node->set_hash(hash);
+                        buckets_.link(idx, node);
+                        ++added[p];
+                    }
+                }
+            });
+        }catch(...){
+            error = std::current_exception();
+        }
+        size_type total = 0;
+        for(size_type c : added) total += c;
+        size_ += total;
+        if(error) std::rethrow_exception(error);
+        return total;
+    }
+
+    Value& operator[](const Key& key){
+        return try_emplace(key).first->second;
+    }
+
+    Value& operator[](Key&& key){
+        return try_emplace(mystl::move(key)).first->second;
+    }
+
+    size_type bucket(const Key& key) const {
+        return (rehashing() ? new_policy_ : policy_).index(hash_of(key));
+    }
+
+    // Machine-readable counterpart of print_debug, see hash_table_stats.
+    // Walks every element, so it is meant for periodic sampling, not for
+    // every operation
+    hash_table_stats stats() const {
+        hash_table_stats s;
+        s.size = size_;
+        s.bucket_count = buckets_.size() + new_buckets_.size();
+        collect_chains(buckets_, s);
+        collect_chains(new_buckets_, s);
+        s.chain_length_histogram[0] = s.bucket_count - s.used_buckets;
+        s.load_factor = static_cast<double>(size_) / static_cast<double>(s.bucket_count);
+        if(size_){
+            double n = static_cast<double>(size_);
+            double m = static_cast<double>(s.bucket_count);
+            s.mean_chain_length = n / static_cast<double>(s.used_buckets);
+            s.bucket_collision_rate = static_cast<double>(size_ - s.used_buckets) / n;
+            // a uniform hash leaves each bucket empty with probability (1 - 1/m)^n
+            double expected_used = m * (1.0 - std::exp(n * std::log1p(-1.0 / m)));
+            s.expected_bucket_collision_rate = 1.0 - expected_used / n;
+            s.hash_collision_rate = static_cast<double>(s.hash_collisions) / n;
+        }
+        s.bytes_allocated = size_ * sizeof(node_type) + buckets_.bytes() + new_buckets_.bytes();
+#if MYSTL_HASHTABLE_STATS
+        s.rehash_count = stat_rehashes_;
+        s.lookups = stat_lookups_.load(std::memory_order_relaxed);
+        s.probes = stat_probes_.load(std::memory_order_relaxed);
+        s.max_probe_length = stat_max_probe_.load(std::memory_order_relaxed);
+        if(s.lookups)
+            s.mean_probe_length = static_cast<double>(s.probes) / static_cast<double>(s.lookups);
+#endif
+        return s;
+    }
+
+    void print_debug() const {
+        print_buckets(buckets_);
+        if(rehashing()){
+            std::cout << "-- rehashing, " << rehash_pos_ << "/" << buckets_.size() << " migrated --\n";
+            print_buckets(new_buckets_);
+        }
+    }
+
+private:
+    // growth check shared by the insert family
+    void prepare_insert(){
+        if(rehashing()){
+            migrate_buckets(rehash_step);
+        }
+        if(!rehashing() && load_factor() > max_load_factor_){
+            if(incremental_) start_rehash(buckets_.size() * 2);
+            else rehash(buckets_.size() * 2);
+        }
+    }
+
+    // new nodes go straight to the table being migrated to
+    iterator link_node(node_type* node, size_type hash){
+        node->set_hash(hash);
+        size_type bucket;
+        if(rehashing()){
+            size_type idx = new_policy_.index(hash);
+            new_buckets_.link(idx, node);
+            bucket = buckets_.size() + idx;
+        }else{
+            bucket = policy_.index(hash);
+            buckets_.link(bucket, node);
+        }
         ++size_;
+        return iterator(this, node, bucket);
+    }
+
+    template <typename It>
+    It first_iterator() const {
+        size_type bucket = static_cast<size_type>(-1);
+        node_type* head = next_bucket_head(bucket);
+        return It(this, head, bucket);
+    }
+
+    template <typename... Args>
+    node_type* create_node(Args&&... args){
+        node_type* node = alloc_.allocate(1);
+        try{
+            alloc_.construct(node, nullptr, mystl::forward<Args>(args)...);
+        }catch(...){
+            alloc_.deallocate(node, 1);
+            throw;
+        }
+        return node;
     }
 
-    Value* find(const Key& key){
-        size_t idx = hasher_(key) % buckets_.size();
+    template <typename K, typename... Args>
+    mystl::pair<iterator, bool> emplace_key(size_type hash, K&& key, Args&&... args){
+        prepare_insert();
+        size_type bucket;
+        if(node_type* found = find_node(key, hash, &bucket)){
+            return {iterator(this, found, bucket), false};
+        }
+        node_type* node = create_node(mystl::piecewise_construct,
+                                      std::forward_as_tuple(mystl::forward<K>(key)),
+                                      std::forward_as_tuple(mystl::forward<Args>(args)...));
+        return {link_node(node, hash), true};
+    }
+
+    template <typename K, typename M>
+    mystl::pair<iterator, bool> assign_key(size_type hash, K&& key, M&& obj){
+        prepare_insert();
+        size_type bucket;
+        if(node_type* found = find_node(key, hash, &bucket)){
+            found->data.second = mystl::forward<M>(obj);
+            return {iterator(this, found, bucket), false};
+        }
+        node_type* node = create_node(mystl::forward<K>(key), mystl::forward<M>(obj));
+        return {link_node(node, hash), true};
+    }
+
+    // head of the first non-empty bucket after bucket (which may be -1),
+    // updating bucket; nullptr at the end
+    node_type* next_bucket_head(size_type& bucket) const {
+        size_type old_count = buckets_.size();
+        size_type i = bucket + 1;
+        if(i < old_count){
+            i = buckets_.next_used(i);
+            if(i < old_count){
+                bucket = i;
+                return buckets_[i];
+            }
+        }
+        if(rehashing()){
+            size_type j = new_buckets_.next_used(i - old_count);
+            if(j < new_buckets_.size()){
+                bucket = old_count + j;
+                return new_buckets_[j];
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename K>
+    Value* find_value(const K& key, size_type hash){
+        if(rehashing()) migrate_buckets(rehash_step);
+        node_type* node = find_node(key, hash);
+        return node ? &node->data.second : nullptr;
+    }
+
+    template <typename K>
+    const Value* find_const(const K& key, size_type hash) const {
+        node_type* node = find_node(key, hash);
+        return node ? &node->data.second : nullptr;
+    }
+
+    template <typename K>
+    bool erase_key(const K& key, size_type hash){
+        if(rehashing()) migrate_buckets(rehash_step);
+        if(erase_from(buckets_, policy_.index(hash), key, hash)) return true;
+        return rehashing() && erase_from(new_buckets_, new_policy_.index(hash), key, hash);
+    }
+
+    // the hash every bucket policy indexes with, and the one nodes store:
+    // mixed unless the hasher already avalanches
+    template <typename K>
+    size_type hash_of(const K& key) const {
+        std::uint64_t h = static_cast<std::uint64_t>(hasher_(key));
+        if constexpr (!hash_is_avalanching<Hash>::value) h = bucket_mix(h);
+        return static_cast<size_type>(h);
+    }
+
+    size_type node_hash(const node_type* node) const {
+        if constexpr (node_type::stores_hash) return node->hash;
+        else return hash_of(node->data.first);
+    }
+
+    template <typename K>
+    bool key_matches(const node_type* node, const K& key, size_type hash) const {
+        if constexpr (node_type::stores_hash)
+            return node->hash == hash && key_equal_(node->data.first, key);
+        else
+            return key_equal_(node->data.first, key);
+    }
+
+    // the old bucket is empty once migrated, so checking it first is safe.
+    // bucket, if given, receives the found node's bucket in iterator order
+    template <typename K>
+    node_type* find_node(const K& key, size_type hash, size_type* bucket = nullptr) const {
+        size_type idx = policy_.index(hash);
+        size_type probes = 0;
         for(node_type* node = buckets_[idx]; node; node = node->next){
-            if(key_equal_(node->data.first, key))
-                return &node->data.second;;
+            ++probes;
+            if(key_matches(node, key, hash)){
+                if(bucket) *bucket = idx;
+                note_lookup(probes);
+                return node;
+            }
         }
+        if(rehashing()){
+            idx = new_policy_.index(hash);
+            for(node_type* node = new_buckets_[idx]; node; node = node->next){
+                ++probes;
+                if(key_matches(node, key, hash)){
+                    if(bucket) *bucket = buckets_.size() + idx;
+                    note_lookup(probes);
+                    return node;
+                }
+            }
+        }
+        note_lookup(probes);
         return nullptr;
     }
 
-    bool erase(const Key& key){
-        size_t idx = hasher_(key) % buckets_.size();
+    // ---------- statistics ----------
+    // both compile to nothing unless MYSTL_HASHTABLE_STATS is set
+    void note_lookup(size_type probes) const noexcept {
+#if MYSTL_HASHTABLE_STATS
+        stat_lookups_.fetch_add(1, std::memory_order_relaxed);
+        stat_probes_.fetch_add(probes, std::memory_order_relaxed);
+        size_type longest = stat_max_probe_.load(std::memory_order_relaxed);
+        while(probes > longest &&
+              !stat_max_probe_.compare_exchange_weak(longest, probes, std::memory_order_relaxed)){
+        }
+#else
+        (void)probes;
+#endif
+    }
+
+    void note_rehash() noexcept {
+#if MYSTL_HASHTABLE_STATS
+        ++stat_rehashes_;
+#endif
+    }
+
+    void collect_chains(const bucket_array& array, hash_table_stats& s) const {
+        for(size_type i = array.next_used(0); i < array.size(); i = array.next_used(i + 1)){
+            size_type length = 0;
+            for(node_type* node = array[i]; node; node = node->next){
+                ++length;
+                size_type hash = node_hash(node);
+                for(node_type* prev = array[i]; prev != node; prev = prev->next){
+                    if(node_hash(prev) == hash){
+                        ++s.hash_collisions;
+                        break;
+                    }
+                }
+            }
+            ++s.used_buckets;
+            ++s.chain_length_histogram[length < hash_table_stats::histogram_bins
+                                           ? length : hash_table_stats::histogram_bins - 1];
+            if(length > s.max_chain_length) s.max_chain_length = length;
+        }
+    }
+
+    // software pipeline over the keys: key i is hashed and its bucket slot
+    // prefetched, key i - batch_distance has its chain head loaded and
+    // prefetched, and key i - 2 * batch_distance is resolved
+    template <typename Emit>
+    void lookup_batch(const Key* keys, size_type n, Emit emit) const {
+        constexpr size_type ring = 4 * batch_distance;  // > 2 * batch_distance, power of two
+        size_type hashes[ring];
+        node_type* const* slots[ring];
+        for(size_type i = 0; i < n + 2 * batch_distance; ++i){
+            if(i < n){
+                size_type r = i & (ring - 1);
+                hashes[r] = hash_of(keys[i]);
+                slots[r] = buckets_.slot(policy_.index(hashes[r]));
+                MYSTL_PREFETCH(slots[r]);
+            }
+            if(i >= batch_distance && i - batch_distance < n){
+                node_type* head = *slots[(i - batch_distance) & (ring - 1)];
+                if(head) MYSTL_PREFETCH(head);
+            }
+            if(i >= 2 * batch_distance){
+                size_type k = i - 2 * batch_distance;
+                emit(k, find_node(keys[k], hashes[k & (ring - 1)]));
+            }
+        }
+    }
+
+    template <typename K>
+    bool erase_from(bucket_array& array, size_type idx, const K& key, size_type hash){
         node_type* prev = nullptr;
-        node_type* curr = buckets_[idx];
+        node_type* curr = array[idx];
         while(curr){
-            if(key_equal_(curr->data.first, key)){
-                if(prev) prev->next = curr->next;
-                else buckets_[idx] = curr->next;
+            if(key_matches(curr, key, hash)){
+                if(prev){
+                    prev->next = curr->next;
+                }else{
+                    array.set_head(idx, curr->next);
+                }
 
                 alloc_.destroy(curr);
                 alloc_.deallocate(curr, 1);
@@ -142,17 +1035,73 @@ public:
         return false;
     }
 
-    Value& operator[](const Key& key){
-        Value* val = find(key);
-        if(val) return *val;
-        insert(key, Value());
-        return *find(key);
+    // free the nodes of buckets until `remaining` nodes are gone; returns
+    // how many are left for the other array
+    size_type free_nodes(bucket_array& buckets, size_type remaining){
+        for(size_type i = 0; remaining; ++i){
+            i = buckets.next_used(i);
+            if(i == buckets.size()) break;
+            node_type* node = buckets.take(i);
+            while(node){
+                node_type* next = node->next;
+                alloc_.destroy(node);
+                alloc_.deallocate(node, 1);
+                node = next;
+                --remaining;
+            }
+        }
+        return remaining;
     }
 
-    void print_debug() const {
-        for (size_t i = 0; i < buckets_.size(); ++i) {
-            node_type* node = buckets_[i];
-            if (!node) continue;
+    // copy-construction helper: clone every node of `from` into buckets_
+    void copy_nodes(const bucket_array& from, const MyHashTable& other){
+        for(size_type i = from.next_used(0); i < from.size(); i = from.next_used(i + 1)){
+            for(const node_type* node = from[i]; node; node = node->next){
+                size_type hash = other.node_hash(node);
+                node_type* copy = create_node(node->data.first, node->data.second);
+                copy->set_hash(hash);
+                buckets_.link(policy_.index(hash), copy);
+                ++size_;
+            }
+        }
+    }
+
+    void start_rehash(size_type new_count){
+        note_rehash();
+        new_count = bucket_policy::bucket_count_for(new_count);
+        new_buckets_ = bucket_array(new_count);
+        new_policy_ = policy_;
+        new_policy_.reset(new_count);
+        rehash_pos_ = 0;
+    }
+
+    // move up to n non-empty old buckets into new_buckets_
+    void migrate_buckets(size_type n){
+        while(n){
+            rehash_pos_ = buckets_.next_used(rehash_pos_);
+            if(rehash_pos_ == buckets_.size()) break;
+            node_type* node = buckets_.take(rehash_pos_);
+            while(node){
+                node_type* next = node->next;
+                new_buckets_.link(new_policy_.index(node_hash(node)), node);
+                node = next;
+            }
+            ++rehash_pos_;
+            --n;
+        }
+        if(rehash_pos_ == buckets_.size()) finish_rehash();
+    }
+
+    void finish_rehash(){
+        buckets_.swap(new_buckets_);
+        policy_ = new_policy_;
+        bucket_array().swap(new_buckets_);
+        rehash_pos_ = 0;
+    }
+
+    void print_buckets(const bucket_array& buckets) const {
+        for (size_t i = buckets.next_used(0); i < buckets.size(); i = buckets.next_used(i + 1)) {
+            node_type* node = buckets[i];
             std::cout << "[" << i << "]: ";
             while (node) {
                 std::cout << "(" << node->data.first << "," << node->data.second << ") -> ";
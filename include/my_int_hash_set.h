@@ -0,0 +1,391 @@
+#ifndef MY_INT_HASH_SET_H
+#define MY_INT_HASH_SET_H
+
+#include "my_allocator.h"
+#include "my_bucket_policy.h"
+#include "my_iterator.h"
+#include "my_utility.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace mystl{
+
+// ======================
+// probing policies
+// ======================
+// linear probing: a key goes into the first empty slot from its home slot on
+struct linear_probing{
+    static constexpr bool robin_hood = false;
+    static constexpr float default_max_load_factor = 0.75f;
+};
+
+// Robin Hood: an insert that has probed further from home than the key in
+// a slot takes that slot and carries the displaced key on. Probe lengths
+// stay short and even, and a miss stops as soon as it has probed further
+// than the key it is looking at, so a fuller table stays fast
+struct robin_hood_probing{
+    static constexpr bool robin_hood = true;
+    static constexpr float default_max_load_factor = 0.875f;
+};
+
+// ======================
+// int hash set iterator
+// ======================
+// walks the slot array, then yields the empty key last if the set holds it
+template <typename Set>
+class int_hash_set_iterator{
+public:
+    using iterator_category = mystl::forward_iterator_tag;
+    using value_type = typename Set::key_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+private:
+    const Set* set_{nullptr};
+    std::size_t idx_{0};
+
+public:
+    int_hash_set_iterator() = default;
+    int_hash_set_iterator(const Set* set, std::size_t idx) : set_(set), idx_(idx) {}
+
+    reference operator*() const {
+        return idx_ < set_->capacity_ ? set_->slots_[idx_] : set_->empty_key_;
+    }
+    pointer operator->() const {return &**this;}
+
+    int_hash_set_iterator& operator++(){
+        idx_ = set_->next_index(idx_ + 1);
+        return *this;
+    }
+
+    int_hash_set_iterator operator++(int){
+        int_hash_set_iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const int_hash_set_iterator& other) const {return idx_ == other.idx_;}
+    bool operator!=(const int_hash_set_iterator& other) const {return idx_ != other.idx_;}
+};
+
+// =====================
+// Int Hash Set
+// =====================
+// An open-addressing set of integers for very large sets of ids: keys live
+// directly in one power-of-two slot array, so a 32-bit key costs 4 bytes
+// divided by the load factor. MyUnorderedSet needs a hash_node with the
+// key twice, a next pointer and a cached hash, plus a bucket pointer and
+// the malloc header on top.
+//
+// A slot holding empty_key (the constructor argument, by default the
+// largest Key) is free. The empty key itself can still be inserted; it is
+// kept outside the array. Erase shifts the rest of the probe run back
+// instead of leaving tombstones, so lookups never slow down under churn.
+template <
+    typename Key,
+    typename Hash = mystl::hash<Key>,
+    typename Alloc = mystl::MyAllocator<Key>,
+    typename Probing = linear_probing>
+class MyIntHashSet{
+    static_assert(std::is_integral<Key>::value && !std::is_same<Key, bool>::value,
+                  "MyIntHashSet: Key must be an integer type");
+
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using allocator_type = Alloc;
+    using probing_policy = Probing;
+    using const_iterator = int_hash_set_iterator<MyIntHashSet>;
+    using iterator = const_iterator;
+
+private:
+    static constexpr size_type npos = static_cast<size_type>(-1);
+    static constexpr size_type min_capacity = 16;
+
+    Key* slots_{nullptr};
+    size_type capacity_{0};        // 0 or 2^k
+    size_type size_{0};            // the empty key included
+    size_type growth_limit_{0};    // filled slots allowed before a resize
+    Key empty_key_;
+    bool has_empty_key_{false};
+    float max_load_factor_{Probing::default_max_load_factor};
+    Hash hasher_;
+    allocator_type alloc_;
+
+    friend class int_hash_set_iterator<MyIntHashSet>;
+
+public:
+    explicit MyIntHashSet(size_type bucket_count = 0, Key empty_key = std::numeric_limits<Key>::max())
+        : empty_key_(empty_key) {
+        if (bucket_count) rehash(bucket_count);
+    }
+
+    MyIntHashSet(const MyIntHashSet& other)
+        : size_(other.size_), empty_key_(other.empty_key_),
+          has_empty_key_(other.has_empty_key_), max_load_factor_(other.max_load_factor_),
+          hasher_(other.hasher_), alloc_(other.alloc_) {
+        if (other.capacity_) {
+            slots_ = alloc_.allocate(other.capacity_);
+            capacity_ = other.capacity_;
+            growth_limit_ = other.growth_limit_;
+            for (size_type i = 0; i < capacity_; ++i) slots_[i] = other.slots_[i];
+        }
+    }
+
+    MyIntHashSet(MyIntHashSet&& other) noexcept
+        : slots_(other.slots_), capacity_(other.capacity_), size_(other.size_),
+          growth_limit_(other.growth_limit_), empty_key_(other.empty_key_),
+          has_empty_key_(other.has_empty_key_), max_load_factor_(other.max_load_factor_),
+          hasher_(other.hasher_), alloc_(other.alloc_) {
+        other.slots_ = nullptr;
+        other.capacity_ = other.size_ = other.growth_limit_ = 0;
+        other.has_empty_key_ = false;
+    }
+
+    MyIntHashSet& operator=(MyIntHashSet other){
+        swap(other);
+        return *this;
+    }
+
+    ~MyIntHashSet(){
+        if (slots_) alloc_.deallocate(slots_, capacity_);
+    }
+
+    bool empty() const noexcept {return size_ == 0;}
+    size_type size() const noexcept {return size_;}
+    size_type bucket_count() const noexcept {return capacity_;}
+    Key empty_key() const noexcept {return empty_key_;}
+
+    float load_factor() const noexcept {
+        return capacity_ ? static_cast<float>(filled()) / static_cast<float>(capacity_) : 0.0f;
+    }
+
+    float max_load_factor() const noexcept {return max_load_factor_;}
+
+    // in (0, 1): a probe needs an empty slot to stop at. Rehashes right
+    // away if the set is already above the new limit
+    void max_load_factor(float ml){
+        if (!(ml > 0.0f && ml < 1.0f))
+            throw std::invalid_argument("MyIntHashSet: max_load_factor must be in (0, 1)");
+        max_load_factor_ = ml;
+        growth_limit_ = growth_for(capacity_);
+        if (filled() > growth_limit_) rehash(0);
+    }
+
+    const_iterator begin() const noexcept {return const_iterator(this, next_index(0));}
+    const_iterator end() const noexcept {return const_iterator(this, capacity_ + 1);}
+    const_iterator cbegin() const noexcept {return begin();}
+    const_iterator cend() const noexcept {return end();}
+
+    // keeps the slot array
+    void clear() noexcept {
+        fill_empty(slots_, capacity_);
+        size_ = 0;
+        has_empty_key_ = false;
+    }
+
+    // true if key was not present
+    bool insert(Key key){
+        if (key == empty_key_) return insert_empty_key();
+        if (filled() >= growth_limit_) {
+            // a full table can still answer "already present"
+            if (capacity_ && find_index(key) != npos) return false;
+            resize(capacity_ ? capacity_ * 2 : min_capacity);
+        }
+        bool inserted = place(key);
+        if (inserted) ++size_;
+        return inserted;
+    }
+
+    bool contains(Key key) const {
+        if (key == empty_key_) return has_empty_key_;
+        return capacity_ && find_index(key) != npos;
+    }
+
+    size_type count(Key key) const {return contains(key) ? 1 : 0;}
+
+    bool erase(Key key){
+        if (key == empty_key_) {
+            if (!has_empty_key_) return false;
+            has_empty_key_ = false;
+            --size_;
+            return true;
+        }
+        if (!capacity_) return false;
+        size_type idx = find_index(key);
+        if (idx == npos) return false;
+        erase_at(idx);
+        --size_;
+        return true;
+    }
+
+    // resize to at least new_count slots, and never below what size() needs
+    void rehash(size_type new_count){
+        size_type wanted = slots_for(filled());
+        if (new_count > wanted) wanted = new_count;
+        size_type new_cap = min_capacity;
+        while (new_cap < wanted) new_cap <<= 1;
+        if (new_cap != capacity_) resize(new_cap);
+    }
+
+    // make room for n keys without any further resize
+    void reserve(size_type n){
+        if (n > growth_limit_) rehash(slots_for(n));
+    }
+
+    void swap(MyIntHashSet& other) noexcept {
+        mystl::swap(slots_, other.slots_);
+        mystl::swap(capacity_, other.capacity_);
+        mystl::swap(size_, other.size_);
+        mystl::swap(growth_limit_, other.growth_limit_);
+        mystl::swap(empty_key_, other.empty_key_);
+        mystl::swap(has_empty_key_, other.has_empty_key_);
+        mystl::swap(max_load_factor_, other.max_load_factor_);
+        mystl::swap(hasher_, other.hasher_);
+    }
+
+    void print_debug() const {
+        for (size_type i = 0; i < capacity_; ++i) {
+            if (slots_[i] == empty_key_) continue;
+            std::cout << "[" << i << "]: " << +slots_[i] << " (home " << home(slots_[i]) << ")\n";
+        }
+        if (has_empty_key_) std::cout << "[empty key]: " << +empty_key_ << "\n";
+    }
+
+private:
+    // ---------- hashing and probing ----------
+    size_type filled() const noexcept {return size_ - (has_empty_key_ ? 1 : 0);}
+
+    size_type home(Key key) const {
+        std::uint64_t h = static_cast<std::uint64_t>(hasher_(key));
+        if constexpr (!hash_is_avalanching<Hash>::value) h = bucket_mix(h);
+        return static_cast<size_type>(h) & (capacity_ - 1);
+    }
+
+    // how far slot idx is from the home slot of the key stored there
+    size_type distance(Key key, size_type idx) const {
+        return (idx - home(key)) & (capacity_ - 1);
+    }
+
+    size_type find_index(Key key) const {
+        size_type mask = capacity_ - 1;
+        size_type idx = home(key);
+        for (size_type dist = 0;; ++dist) {
+            Key slot = slots_[idx];
+            if (slot == key) return idx;
+            if (slot == empty_key_) return npos;
+            // every key after this one in the run lies closer to its home
+            if constexpr (Probing::robin_hood) {
+                if (distance(slot, idx) < dist) return npos;
+            }
+            idx = (idx + 1) & mask;
+        }
+    }
+
+    // insert a key that is not the empty key into a table with room for it
+    bool place(Key key){
+        size_type mask = capacity_ - 1;
+        size_type idx = home(key);
+        for (size_type dist = 0;; ++dist) {
+            Key slot = slots_[idx];
+            if (slot == empty_key_) {
+                slots_[idx] = key;
+                return true;
+            }
+            if (slot == key) return false;
+            if constexpr (Probing::robin_hood) {
+                size_type slot_dist = distance(slot, idx);
+                if (slot_dist < dist) {
+                    slots_[idx] = key;
+                    key = slot;
+                    dist = slot_dist;
+                }
+            }
+            idx = (idx + 1) & mask;
+        }
+    }
+
+    // Shift later keys of the run back over the hole. Robin Hood keeps the
+    // run ordered by distance, so the shift ends at the first key already
+    // at home; linear probing moves any key whose probe path crosses the
+    // hole (Knuth's algorithm R)
+    void erase_at(size_type hole){
+        size_type mask = capacity_ - 1;
+        size_type idx = hole;
+        for (;;) {
+            idx = (idx + 1) & mask;
+            Key slot = slots_[idx];
+            if (slot == empty_key_) break;
+            size_type slot_dist = distance(slot, idx);
+            if constexpr (Probing::robin_hood) {
+                if (slot_dist == 0) break;
+            } else {
+                if (slot_dist < ((idx - hole) & mask)) continue;
+            }
+            slots_[hole] = slot;
+            hole = idx;
+        }
+        slots_[hole] = empty_key_;
+    }
+
+    bool insert_empty_key() noexcept {
+        if (has_empty_key_) return false;
+        has_empty_key_ = true;
+        ++size_;
+        return true;
+    }
+
+    // ---------- capacity ----------
+    // one slot always stays empty so every probe ends
+    size_type growth_for(size_type cap) const noexcept {
+        if (!cap) return 0;
+        size_type limit = static_cast<size_type>(static_cast<float>(cap) * max_load_factor_);
+        return limit < cap ? limit : cap - 1;
+    }
+
+    size_type slots_for(size_type n) const noexcept {
+        return static_cast<size_type>(static_cast<float>(n) / max_load_factor_) + 1;
+    }
+
+    void fill_empty(Key* slots, size_type n) const noexcept {
+        for (size_type i = 0; i < n; ++i) slots[i] = empty_key_;
+    }
+
+    void resize(size_type new_cap){
+        Key* old_slots = slots_;
+        size_type old_cap = capacity_;
+        slots_ = alloc_.allocate(new_cap);
+        capacity_ = new_cap;
+        growth_limit_ = growth_for(new_cap);
+        fill_empty(slots_, new_cap);
+        for (size_type i = 0; i < old_cap; ++i) {
+            if (old_slots[i] != empty_key_) place(old_slots[i]);
+        }
+        if (old_slots) alloc_.deallocate(old_slots, old_cap);
+    }
+
+    size_type next_index(size_type idx) const noexcept {
+        while (idx < capacity_ && slots_[idx] == empty_key_) ++idx;
+        if (idx == capacity_ && !has_empty_key_) ++idx;
+        return idx;
+    }
+};
+
+// the same set with Robin Hood probing
+template <
+    typename Key,
+    typename Hash = mystl::hash<Key>,
+    typename Alloc = mystl::MyAllocator<Key>>
+using MyRobinHoodIntSet = MyIntHashSet<Key, Hash, Alloc, robin_hood_probing>;
+
+} // namespace mystl
+
+#endif // MY_INT_HASH_SET_H
@@ -2,6 +2,8 @@
 #define MY_ITERATOR_H
 
 #include <cstddef>
+#include <iterator>
+#include <type_traits>
 
 namespace mystl {
 
@@ -53,12 +55,73 @@ struct iterator_traits<const T*> {
 };
 
 
+// =================================================
+// iterator category checks
+// accept both mystl and std tags, so ranges from std containers
+// can feed the mystl ones
+// =================================================
+template <typename It, typename = void>
+struct has_iterator_category : std::false_type {};
+
+template <typename It>
+struct has_iterator_category<It, std::void_t<typename It::iterator_category>>
+    : std::true_type {};
+
+template <typename T>
+struct has_iterator_category<T*, void> : std::true_type {};
+
+template <typename It, typename MyTag, typename StdTag, bool = has_iterator_category<It>::value>
+struct iterator_category_is : std::false_type {};
+
+template <typename It, typename MyTag, typename StdTag>
+struct iterator_category_is<It, MyTag, StdTag, true>
+    : std::integral_constant<bool,
+          std::is_convertible<typename iterator_traits<It>::iterator_category, MyTag>::value ||
+          std::is_convertible<typename iterator_traits<It>::iterator_category, StdTag>::value> {};
+
+template <typename It>
+struct is_input_iterator
+    : iterator_category_is<It, input_iterator_tag, std::input_iterator_tag> {};
+
+template <typename It>
+struct is_forward_iterator
+    : iterator_category_is<It, forward_iterator_tag, std::forward_iterator_tag> {};
+
+template <typename It>
+struct is_bidirectional_iterator
+    : iterator_category_is<It, bidirectional_iterator_tag, std::bidirectional_iterator_tag> {};
+
+template <typename It>
+struct is_random_access_iterator
+    : iterator_category_is<It, random_access_iterator_tag, std::random_access_iterator_tag> {};
+
+// the mystl tag matching It's category, whichever tag family It uses
+template <typename It>
+using iterator_category_t =
+    typename std::conditional<is_random_access_iterator<It>::value, random_access_iterator_tag,
+    typename std::conditional<is_bidirectional_iterator<It>::value, bidirectional_iterator_tag,
+    typename std::conditional<is_forward_iterator<It>::value, forward_iterator_tag,
+                              input_iterator_tag>::type>::type>::type;
+
 // calculate the distance between two iterators
+template <typename InputIterator>
+typename iterator_traits<InputIterator>::difference_type
+distance_impl(InputIterator first, InputIterator last, input_iterator_tag) {
+    typename iterator_traits<InputIterator>::difference_type n = 0;
+    for (; first != last; ++first) ++n;
+    return n;
+}
+
+template <typename RandomAccessIterator>
+typename iterator_traits<RandomAccessIterator>::difference_type
+distance_impl(RandomAccessIterator first, RandomAccessIterator last, random_access_iterator_tag) {
+    return last - first;
+}
+
 template <typename InputIterator>
 typename iterator_traits<InputIterator>::difference_type
 distance(InputIterator first, InputIterator last) {
-    using category = typename iterator_traits<InputIterator>::iterator_category;
-    return distance_impl(first, last, category());
+    return distance_impl(first, last, iterator_category_t<InputIterator>());
 }
 
 // position of the iterator
@@ -84,8 +147,7 @@ void advance(RandomAccessIterator& it, Distance n, random_access_iterator_tag) {
 
 template <typename Iterator, typename Distance>
 void advance(Iterator& it, Distance n) {
-    using category = typename iterator_traits<Iterator>::iterator_category;
-    advance(it, n, category());
+    advance(it, n, iterator_category_t<Iterator>());
 }
 
 // =================================================
@@ -221,6 +283,12 @@ public:
         return vector_iterator(ptr_ - n);
     }
 
+    vector_iterator& operator+=(difference_type n) {ptr_ += n; return *this;}
+
+    vector_iterator& operator-=(difference_type n) {ptr_ -= n; return *this;}
+
+    reference operator[](difference_type n) const {return ptr_[n];}
+
     difference_type operator-(const vector_iterator& other) const {
         return ptr_ - other.ptr_;
     }
@@ -3,6 +3,7 @@
 
 #include "my_allocator.h"
 #include "my_iterator.h"
+#include "my_utility.h"
 
 #include <initializer_list>
 #include <cstddef>
@@ -19,7 +20,11 @@ struct list_node{
     list_node* prev;
     list_node* next;
     T data;
-    list_node(const T& value = T()) : prev(nullptr), next(nullptr), data(value){}
+    list_node() : prev(nullptr), next(nullptr), data(){}
+
+    // build data in place from args
+    template <typename... Args>
+    explicit list_node(Args&&... args) : prev(nullptr), next(nullptr), data(mystl::forward<Args>(args)...){}
 };
 
 // ===================
@@ -29,7 +34,7 @@ struct list_node{
 template <typename T>
 class list_iterator{
 public:
-    using iterator_catagory = mystl::bidirectional_iterator_tag;
+    using iterator_category = mystl::bidirectional_iterator_tag;
     using value_type = T;
     using difference_type = std::ptrdiff_t;
     using pointer = T*;
@@ -134,10 +139,28 @@ public:
         insert_node_before(head_, value); //insert before sentinel
     }
 
+    void push_back(T&& value){
+        insert_node_before(head_, mystl::move(value));
+    }
+
     void push_front(const T& value){
         insert_node_before(head_->next, value);
     }
 
+    void push_front(T&& value){
+        insert_node_before(head_->next, mystl::move(value));
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args){
+        return insert_node_before(head_, mystl::forward<Args>(args)...)->data;
+    }
+
+    template <typename... Args>
+    reference emplace_front(Args&&... args){
+        return insert_node_before(head_->next, mystl::forward<Args>(args)...)->data;
+    }
+
     void pop_back(){
         erase(head_->prev);
     }
@@ -158,16 +181,16 @@ public:
     }
 
     iterator insert(iterator pos, const T& value){
-        node_ptr new_node = create_node(value);
-        node_ptr cur = pos.get_node();
+        return emplace(pos, value);
+    }
 
-        new_node->next = cur;
-        new_node->prev = cur->prev;
-        cur->prev->next = new_node;
-        cur->prev = new_node;
+    iterator insert(iterator pos, T&& value){
+        return emplace(pos, mystl::move(value));
+    }
 
-        ++size_;
-        return iterator(new_node);
+    template <typename... Args>
+    iterator emplace(iterator pos, Args&&... args){
+        return iterator(insert_node_before(pos.get_node(), mystl::forward<Args>(args)...));
     }
 
     iterator erase(iterator pos){
@@ -185,7 +208,7 @@ public:
 private:
     void create_head(){
         head_ = alloc_.allocate(1);
-        alloc_.construct(head_, node_type()); // properly construct sentinel
+        alloc_.construct(head_); // properly construct sentinel
         head_->next = head_;
         head_->prev = head_;
     }
@@ -196,9 +219,15 @@ private:
         head_ = nullptr;
     }
 
-    node_ptr create_node(const T& value){
+    template <typename... Args>
+    node_ptr create_node(Args&&... args){
         node_ptr p = alloc_.allocate(1);
-        alloc_.construct(p, value); // call list_node<T>(const T&) directly
+        try{
+            alloc_.construct(p, mystl::forward<Args>(args)...); // build T inside the node
+        }catch(...){
+            alloc_.deallocate(p, 1);
+            throw;
+        }
         return p;
     }
 
@@ -207,13 +236,15 @@ private:
         alloc_.deallocate(p, 1);
     }
 
-    void insert_node_before(node_ptr pos, const T& value){
-        node_ptr new_node = create_node(value);
+    template <typename... Args>
+    node_ptr insert_node_before(node_ptr pos, Args&&... args){
+        node_ptr new_node = create_node(mystl::forward<Args>(args)...);
         new_node->next = pos;
         new_node->prev = pos->prev;
         pos->prev->next = new_node;
         pos->prev = new_node;
         ++size_;
+        return new_node;
     }
 };
 
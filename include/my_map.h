@@ -3,6 +3,7 @@
 
 #include "my_utility.h"
 #include  "my_rbtree.h"
+#include "my_btree.h"
 
 namespace mystl {
 
@@ -16,12 +17,13 @@ struct select1st{
 
 
 template <typename Key, typename T, typename Compare = mystl::less<Key>,
-          typename Alloc = mystl::MyAllocator<mystl::RBTreeNode<mystl::pair<const Key, T>>>>
+          typename Alloc = mystl::MyAllocator<mystl::RBTreeNode<mystl::pair<const Key, T>>>,
+          typename TreeBackend = mystl::rbtree_backend>
 class MyMap{
 
 private:
     using value_type = mystl::pair<const Key, T>;
-    using tree_type = mystl::MyRBTree<Key, value_type, select1st<value_type>, Compare, Alloc>;
+    using tree_type = typename TreeBackend::template tree<Key, value_type, select1st<value_type>, Compare, Alloc>;
     tree_type tree_;
 
 public:
@@ -33,6 +35,13 @@ public:
 
     MyMap() = default;
 
+    // linear time when [first, last) is sorted by key, see insert_sorted
+    template <typename InputIt,
+              typename std::enable_if<mystl::is_input_iterator<InputIt>::value, int>::type = 0>
+    MyMap(InputIt first, InputIt last){
+        insert_sorted(first, last);
+    }
+
     bool empty() const noexcept {return tree_.empty();}
 
     size_type size() const noexcept {return tree_.size();}
@@ -43,32 +52,109 @@ public:
 
     // insert unique key
     mystl::pair<iterator, bool> insert(const value_type& value){
-        auto it = tree_.find(value.first);
-        if(it != tree_.end()){
-            return {it, false};
-        }
-        it = tree_.insert_equal(value);
-        return {it, true};
+        return tree_.insert_unique(value);
+    }
+
+    // hint is the element the new one would go right before, end() for
+    // the largest: with a right hint, e.g. end() for keys arriving in
+    // order, the insert is amortized O(1); a wrong one costs a descent
+    iterator insert(iterator hint, const value_type& value){
+        return tree_.insert_unique(hint, value);
+    }
+
+    // insert a range sorted by key: into an empty container, or past the
+    // largest key, in O(n) rather than one descent per element. The first
+    // of equal keys wins and keys already present are kept; elements out
+    // of order still go in, one insert at a time
+    template <typename InputIt>
+    void insert_sorted(InputIt first, InputIt last){
+        tree_.insert_sorted_unique(first, last);
     }
 
     // Element access
+    // one descent: insert_unique returns the existing node when key is there
     mapped_type& operator[](const key_type& key){
-        auto it = tree_.find(key);
-        if(it == tree_.end()){
-            it = tree_.insert_equal(mystl::make_pair(key, T()));
-        }
-
-        return (*it).second;
+        return (*tree_.insert_unique(mystl::make_pair(key, T())).first).second;
     }
 
     iterator find(const key_type& key){return tree_.find(key);}
 
+    bool contains(const key_type& key) const {return tree_.contains(key);}
+
+    size_type count(const key_type& key) const {return tree_.contains(key) ? 1 : 0;}
+
+    // ===== range queries =====
+    // first element with key not before / after key
+    iterator lower_bound(const key_type& key){return tree_.lower_bound(key);}
+    iterator upper_bound(const key_type& key){return tree_.upper_bound(key);}
+
+    mystl::pair<iterator, iterator> equal_range(const key_type& key){return tree_.equal_range(key);}
+
+    // number of keys in [low, high): O(log n) with ranked_rbtree_backend,
+    // otherwise a walk over the range
+    size_type count_range(const key_type& low, const key_type& high) const {
+        return tree_.count_range(low, high);
+    }
+
+    // order statistics, ranked_rbtree_backend only: how many keys come
+    // before key, and the element at index i in key order (end() past it)
+    size_type rank(const key_type& key) const {return tree_.rank(key);}
+    iterator select(size_type i){return tree_.select(i);}
+
     void erase(const key_type& key){
         auto it = tree_.find(key);
         if(it != tree_.end()){
             tree_.erase(it);
         }
     }
+
+    void clear(){tree_.clear();}
+
+    // lookups by any type a transparent Compare (e.g. mystl::less<>) can
+    // order against Key, without converting it to a Key first
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    iterator find(const K& key){return tree_.find(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    bool contains(const K& key) const {return tree_.contains(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    size_type count(const K& key) const {return tree_.contains(key) ? 1 : 0;}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    iterator lower_bound(const K& key){return tree_.lower_bound(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    iterator upper_bound(const K& key){return tree_.upper_bound(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    mystl::pair<iterator, iterator> equal_range(const K& key){return tree_.equal_range(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    void erase(const K& key){
+        auto it = tree_.find(key);
+        if(it != tree_.end()){
+            tree_.erase(it);
+        }
+    }
 };
+
+// MyMap stored in a B+ tree: wide nodes and chained leaves for scan-heavy
+// and large maps
+template <typename Key, typename T, typename Compare = mystl::less<Key>>
+using MyBTreeMap = MyMap<Key, T, Compare, mystl::MyAllocator<mystl::pair<const Key, T>>, mystl::btree_backend<>>;
+
+// MyMap with rank() and select()
+template <typename Key, typename T, typename Compare = mystl::less<Key>>
+using MyRankedMap = MyMap<Key, T, Compare,
+                          mystl::MyAllocator<mystl::RBTreeNode<mystl::pair<const Key, T>>>,
+                          mystl::ranked_rbtree_backend>;
+
+// MyMap whose nodes come from a per-map MyNodePool: clear() and the
+// destructor free whole blocks, without visiting trivially destructible
+// nodes. For maps that are built, read and thrown away
+template <typename Key, typename T, typename Compare = mystl::less<Key>>
+using MyPooledMap = MyMap<Key, T, Compare, mystl::MyNodePool<mystl::RBTreeNode<mystl::pair<const Key, T>>>>;
+
 } // namespace mystl
 #endif //MY_MAP_H
\ No newline at end of file
@@ -2,13 +2,15 @@
 #define MY_MyMultimap_H
 
 #include "my_rbtree.h"
+#include "my_btree.h"
 #include "my_utility.h"
 
 namespace mystl {
 
 template <typename Key, typename T,
           typename Compare = std::less<Key>,
-          typename Alloc = mystl::MyAllocator<RBTreeNode< std::pair<const Key, T> >>>
+          typename Alloc = mystl::MyAllocator<RBTreeNode< std::pair<const Key, T> >>,
+          typename TreeBackend = mystl::rbtree_backend>
 class MyMultimap {
 public:
     using key_type       = Key;
@@ -22,7 +24,7 @@ private:
     using key_of_value = mystl::extract_key<value_type>;
 
     using tree_type =
-        MyRBTree<Key, value_type, key_of_value, Compare, Alloc>;
+        typename TreeBackend::template tree<Key, value_type, key_of_value, Compare, Alloc>;
 
     tree_type tree_;
 
@@ -53,8 +55,35 @@ public:
 
     // -------- lookup ----------
     iterator find(const key_type& k) { return tree_.find(k); }
+
+    size_type count(const key_type& k) const { return tree_.count(k); }
+
+    iterator lower_bound(const key_type& k) { return tree_.lower_bound(k); }
+    iterator upper_bound(const key_type& k) { return tree_.upper_bound(k); }
+
+    mystl::pair<iterator, iterator> equal_range(const key_type& k) { return tree_.equal_range(k); }
+
+    // elements with keys in [low, high)
+    size_type count_range(const key_type& low, const key_type& high) const {
+        return tree_.count_range(low, high);
+    }
+
+    // -------- order statistics (ranked_rbtree_backend) ----------
+    size_type rank(const key_type& k) const { return tree_.rank(k); }
+    iterator select(size_type i) { return tree_.select(i); }
 };
 
+// MyMultimap stored in a B+ tree
+template <typename Key, typename T, typename Compare = std::less<Key>>
+using MyBTreeMultimap =
+    MyMultimap<Key, T, Compare, mystl::MyAllocator<std::pair<const Key, T>>, mystl::btree_backend<>>;
+
+// MyMultimap with rank() and select(), and count() in O(log n)
+template <typename Key, typename T, typename Compare = std::less<Key>>
+using MyRankedMultimap =
+    MyMultimap<Key, T, Compare, mystl::MyAllocator<RBTreeNode<std::pair<const Key, T>>>,
+               mystl::ranked_rbtree_backend>;
+
 } // namespace mystl
 
 #endif // MY_MyMultimap_H
@@ -2,6 +2,7 @@
 #define MY_MULTI_SET
 
 #include "my_rbtree.h"
+#include "my_btree.h"
 #include "my_utility.h"
 #include "my_allocator.h"
 #include <cstddef>
@@ -10,7 +11,8 @@ namespace mystl {
 
 template<typename Key,
          typename Compare = std::less<Key>,
-         typename Alloc = mystl::MyAllocator<RBTreeNode<Key>>>
+         typename Alloc = mystl::MyAllocator<RBTreeNode<Key>>,
+         typename TreeBackend = mystl::rbtree_backend>
 class MyMultiset {
 public:
     using key_type = Key;
@@ -21,7 +23,7 @@ public:
 
 private:
     using tree_type = 
-        MyRBTree<Key, value_type, mystl::identity<value_type>, Compare, Alloc>;
+        typename TreeBackend::template tree<Key, value_type, mystl::identity<value_type>, Compare, Alloc>;
     
     tree_type tree_;
 
@@ -56,7 +58,31 @@ public:
 
     // lookup
     iterator find(const key_type& key) {return tree_.find(key);}
+
+    size_type count(const key_type& key) const {return tree_.count(key);}
+
+    iterator lower_bound(const key_type& key) {return tree_.lower_bound(key);}
+    iterator upper_bound(const key_type& key) {return tree_.upper_bound(key);}
+
+    mystl::pair<iterator, iterator> equal_range(const key_type& key) {return tree_.equal_range(key);}
+
+    // elements with keys in [low, high)
+    size_type count_range(const key_type& low, const key_type& high) const {
+        return tree_.count_range(low, high);
+    }
+
+    // order statistics (ranked_rbtree_backend)
+    size_type rank(const key_type& key) const {return tree_.rank(key);}
+    iterator select(size_type i) {return tree_.select(i);}
 };
 
+// MyMultiset stored in a B+ tree
+template <typename Key, typename Compare = std::less<Key>>
+using MyBTreeMultiset = MyMultiset<Key, Compare, mystl::MyAllocator<Key>, mystl::btree_backend<>>;
+
+// MyMultiset with rank() and select(), and count() in O(log n)
+template <typename Key, typename Compare = std::less<Key>>
+using MyRankedMultiset = MyMultiset<Key, Compare, mystl::MyAllocator<RBTreeNode<Key>>, mystl::ranked_rbtree_backend>;
+
 } // namespace mystl
 #endif //MU_MULTI_SET
\ No newline at end of file
@@ -0,0 +1,183 @@
+#ifndef MY_NODE_POOL_H
+#define MY_NODE_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mystl{
+
+// ===============================
+// node pool allocator
+// ===============================
+// A drop-in for MyAllocator in node containers (MyHashTable and the
+// unordered containers). Single-node requests are carved out of
+// cache-line-aligned blocks of about BlockBytes and recycled through a free
+// list on deallocate, so insert/erase churn neither calls the global
+// allocator nor scatters nodes across the heap. Larger requests go to
+// operator new.
+//
+// The pool belongs to one allocator object: copies start with an empty
+// pool, moves take the blocks along, and every block is released when the
+// owning allocator is destroyed, or earlier by release(). Nodes must not
+// outlive it.
+template <class T, std::size_t BlockBytes = 4096>
+class MyNodePool{
+public:
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using value_type = T;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using reference = T&;
+
+    static constexpr std::size_t block_alignment = 64;
+
+    template <class U>
+    struct rebind{
+        using other = MyNodePool<U, BlockBytes>;
+    };
+
+private:
+    union slot{
+        slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // blocks are chained through a header in front of their slots
+    struct block_header{
+        block_header* next;
+    };
+
+    static constexpr std::size_t slots_offset =
+        (sizeof(block_header) + alignof(slot) - 1) / alignof(slot) * alignof(slot);
+    static constexpr std::size_t slots_per_block =
+        BlockBytes > slots_offset + sizeof(slot) ? (BlockBytes - slots_offset) / sizeof(slot) : 1;
+    static constexpr std::size_t block_bytes = slots_offset + slots_per_block * sizeof(slot);
+
+    block_header* blocks_{nullptr};
+    slot* free_list_{nullptr};
+    slot* bump_{nullptr};       // next never-used slot of the newest block
+    slot* bump_end_{nullptr};
+
+public:
+    MyNodePool() = default;
+
+    MyNodePool(const MyNodePool&) noexcept {}
+
+    template <class U, std::size_t B>
+    MyNodePool(const MyNodePool<U, B>&) noexcept {}
+
+    MyNodePool(MyNodePool&& other) noexcept
+        : blocks_(other.blocks_), free_list_(other.free_list_),
+          bump_(other.bump_), bump_end_(other.bump_end_) {
+        other.blocks_ = nullptr;
+        other.free_list_ = other.bump_ = other.bump_end_ = nullptr;
+    }
+
+    MyNodePool& operator=(const MyNodePool&) noexcept {return *this;}
+
+    MyNodePool& operator=(MyNodePool&& other) noexcept {
+        if (this != &other) {
+            release();
+            blocks_ = other.blocks_;
+            free_list_ = other.free_list_;
+            bump_ = other.bump_;
+            bump_end_ = other.bump_end_;
+            other.blocks_ = nullptr;
+            other.free_list_ = other.bump_ = other.bump_end_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~MyNodePool() {release();}
+
+    pointer allocate(size_type n) {
+        if (n != 1) {
+            if (n > static_cast<size_type>(-1) / sizeof(value_type)) throw std::bad_alloc();
+            return static_cast<pointer>(::operator new(n * sizeof(value_type)));
+        }
+        slot* s = free_list_;
+        if (s) {
+            free_list_ = s->next;
+        } else {
+            if (bump_ == bump_end_) add_block();
+            s = bump_++;
+        }
+        return reinterpret_cast<pointer>(s->storage);
+    }
+
+    void deallocate(pointer p, size_type n) noexcept {
+        if (n != 1) {
+            ::operator delete(p);
+            return;
+        }
+        slot* s = reinterpret_cast<slot*>(p);
+        s->next = free_list_;
+        free_list_ = s;
+    }
+
+    template <class... Args>
+    static void construct(pointer p, Args&&... args) {
+        ::new (p) value_type(std::forward<Args>(args)...);
+    }
+
+    static void destroy(pointer p) noexcept {
+        p->~T();
+    }
+
+    // blocks currently held, for tests and tuning
+    size_type block_count() const noexcept {
+        size_type n = 0;
+        for (block_header* b = blocks_; b; b = b->next) ++n;
+        return n;
+    }
+
+    static constexpr size_type nodes_per_block() noexcept {return slots_per_block;}
+
+    // free every block at once, live nodes included: the caller must have
+    // destroyed them, or not need to. The pool can be used again afterwards
+    void release() noexcept {
+        while (blocks_) {
+            block_header* next = blocks_->next;
+            ::operator delete(static_cast<void*>(blocks_), std::align_val_t(block_alignment));
+            blocks_ = next;
+        }
+        free_list_ = bump_ = bump_end_ = nullptr;
+    }
+
+private:
+    void add_block() {
+        void* raw = ::operator new(block_bytes, std::align_val_t(block_alignment));
+        block_header* block = static_cast<block_header*>(raw);
+        block->next = blocks_;
+        blocks_ = block;
+        bump_ = reinterpret_cast<slot*>(static_cast<unsigned char*>(raw) + slots_offset);
+        bump_end_ = bump_ + slots_per_block;
+    }
+};
+
+// every pool owns its own blocks, so two pools are never interchangeable
+template <class T, std::size_t B1, class U, std::size_t B2>
+bool operator==(const MyNodePool<T, B1>& lhs, const MyNodePool<U, B2>& rhs) noexcept {
+    return static_cast<const void*>(&lhs) == static_cast<const void*>(&rhs);
+}
+
+template <class T, std::size_t B1, class U, std::size_t B2>
+bool operator!=(const MyNodePool<T, B1>& lhs, const MyNodePool<U, B2>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+// allocators that own their nodes' memory in blocks and can drop it all
+// with release(), so a container being cleared need not free node by node
+template <class Alloc>
+struct is_node_arena : std::false_type {};
+
+template <class T, std::size_t BlockBytes>
+struct is_node_arena<MyNodePool<T, BlockBytes>> : std::true_type {};
+
+} // namespace mystl
+
+#endif // MY_NODE_POOL_H
@@ -2,9 +2,15 @@
 #define MY_RBTREE_H
 
 #include "my_allocator.h"
+#include "my_node_pool.h"
 #include "my_utility.h"
 #include "my_iterator.h"
 
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 namespace mystl{
 
 // ===================
@@ -26,6 +32,14 @@ struct RBTreeNode{
         : value(v), parent(nullptr), left(nullptr), right(nullptr), color(RBTreeColor::Red){}
 };
 
+// node of an order statistics tree: also counts the nodes of its subtree
+template <typename T>
+struct RBTreeRankedNode : RBTreeNode<T>{
+    std::size_t size;
+
+    RBTreeRankedNode(const T& v) : RBTreeNode<T>(v), size(1){}
+};
+
 // ====================
 // rb tree iterator
 // ====================
@@ -117,7 +131,7 @@ public:
 // rb tree 
 // =====================
 template <typename Key, typename Value, typename KeyOfValue, typename Compare, 
-          typename Alloc = mystl::MyAllocator<RBTreeNode<Value>>>
+          typename Alloc = mystl::MyAllocator<RBTreeNode<Value>>, bool Ranked = false>
 class MyRBTree
 {
 public:
@@ -128,6 +142,10 @@ public:
     using node_ptr = node*;
     using allocator_type = Alloc;
 
+    // Ranked trees allocate RBTreeRankedNode and keep subtree sizes, for
+    // O(log n) rank(), select() and counts; links stay plain node pointers
+    static constexpr bool ranked = Ranked;
+
     using iterator = RBTreeIterator<Value>;
     using const_iterator = RBTreeIterator<const Value>;
     using reference = Value&;
@@ -135,10 +153,20 @@ public:
 
 
 private:
+    using ranked_node = RBTreeRankedNode<Value>;
+    using stored_node = std::conditional_t<Ranked, ranked_node, node>;
+    using node_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<stored_node>;
+
+    // with a node arena (e.g. MyNodePool) clear() and the destructor hand
+    // the blocks back whole; nodes with nothing to destroy are not even
+    // visited, so that takes O(blocks) instead of a walk over the tree
+    static constexpr bool arena = is_node_arena<node_allocator>::value;
+    static constexpr bool drop_in_bulk = arena && std::is_trivially_destructible<stored_node>::value;
+
     node_ptr header_; // sentinel node (header_ -> parent is root)
     size_type node_count_;
     Compare comp_;
-    allocator_type alloc_;
+    node_allocator alloc_;
 
     node_ptr& root() const noexcept {return header_ -> parent;}
     node_ptr& leftmost() const noexcept {return header_ -> left;}
@@ -149,7 +177,7 @@ public:
     MyRBTree() : node_count_(0), comp_(Compare()), alloc_() {
         //alloc_.construct(header_, Value{});
 
-        header_ = create_node(Value{});
+        header_ = create_header();
         
         header_->color = RBTreeColor::Red;
         header_ ->parent = nullptr;
@@ -159,7 +187,7 @@ public:
     }
     
     explicit MyRBTree(const Compare& comp) : node_count_(0), comp_(comp), alloc_() {
-        header_ = create_node(Value{});
+        header_ = create_header();
 
         header_->color = RBTreeColor::Red;
         header_->parent = nullptr;
@@ -170,7 +198,7 @@ public:
     ~MyRBTree () {
         //std::cout << "[DEBUG] Destroying RBTree, nodes=" << node_count_ << "\n";
         clear();
-        destroy_node(header_); 
+        destroy_header(header_);
         header_ = nullptr;
         //std::cout << "[DEBUG] Header destroyed\n";
     }
@@ -185,8 +213,13 @@ public:
 
     // ========= node destroy and create ========
     node_ptr create_node(const value_type& value){
-        node_ptr n = alloc_.allocate(1);
-        alloc_.construct(n, value);
+        stored_node* n = alloc_.allocate(1);
+        try {
+            alloc_.construct(n, value);
+        } catch (...) {
+            alloc_.deallocate(n, 1);
+            throw;
+        }
 
         n->parent = n->left = n -> right = nullptr;
         n-> color = RBTreeColor::Red;
@@ -194,15 +227,39 @@ public:
     }
 
     void destroy_node(node_ptr n){
-        alloc_.destroy(n);
-        alloc_.deallocate(n, 1);
+        stored_node* s = static_cast<stored_node*>(n);
+        alloc_.destroy(s);
+        alloc_.deallocate(s, 1);
+    }
+
+    // an arena's header lives outside it, so releasing the arena leaves
+    // end() intact
+    node_ptr create_header(){
+        if constexpr (arena){
+            return new stored_node(Value{});
+        }else{
+            return create_node(Value{});
+        }
+    }
+
+    void destroy_header(node_ptr h){
+        if constexpr (arena){
+            delete static_cast<stored_node*>(h);
+        }else{
+            destroy_node(h);
+        }
     }
 
     void clear(){
         if(root()){
-            clear_subtree(root());
+            if constexpr (!drop_in_bulk){
+                clear_subtree(root());
+            }
             root() = nullptr;
         }
+        if constexpr (arena){
+            alloc_.release();
+        }
         leftmost() = header_;
         rightmost() = header_;
         header_->parent = nullptr;
@@ -210,40 +267,82 @@ public:
     }
 
     iterator insert_equal(const value_type& v){
-        node_ptr y = header_;  // 
-        node_ptr x = root();
+        node_ptr z = create_node(v);
+        link_equal(z);
+        return iterator(z);
+    }
 
-        while(x != nullptr){
-            y = x;
-            if( comp_(KeyOfValue()(v), KeyOfValue()(x->value))){
-                x = x->left;
-            }else{
-                x = x-> right;
-            }
+    // insert v unless its key is already in the tree; the bool says which
+    mystl::pair<iterator, bool> insert_unique(const value_type& v){
+        unique_pos pos = find_unique_pos(KeyOfValue()(v));
+        if(pos.existing){
+            return {iterator(pos.existing), false};
         }
+        node_ptr z = create_node(v);
+        attach(z, pos.parent, pos.left);
+        return {iterator(z), true};
+    }
 
+    // insert_unique with a hint: the element v's key would come right
+    // before (end() for the largest). Amortized O(1) when the hint is right,
+    // one descent when it is not. Returns v's node, or the one that had
+    // its key already
+    iterator insert_unique(iterator hint, const value_type& v){
+        unique_pos pos = find_unique_pos(hint, KeyOfValue()(v));
+        if(pos.existing){
+            return iterator(pos.existing);
+        }
         node_ptr z = create_node(v);
-        z->parent = y;
+        attach(z, pos.parent, pos.left);
+        return iterator(z);
+    }
 
-        if(y == header_){
-            root() = z;
-            leftmost() = z;
-            rightmost() = z;
-        }else if (comp_(KeyOfValue()(v), KeyOfValue()(y->value))){
-            y->left = z;
-            if(y == leftmost()){
-                leftmost() = z;
+    // insert a range sorted by key, skipping keys already in the tree and
+    // all but the first of equal keys in the range. Into an empty tree, or
+    // past rightmost(), the run costs O(n): the nodes are linked into a
+    // balanced tree, or appended, without comparing against the tree.
+    // Elements out of order are inserted one at a time
+    template <typename InputIt>
+    void insert_sorted_unique(InputIt first, InputIt last){
+        std::vector<node_ptr> run;
+        node_ptr stray = nullptr;   // first element out of order, if any
+        try {
+            for(; first != last; ++first){
+                node_ptr z = create_node(*first);
+                if(!run.empty() && !comp_(KeyOfValue()(run.back()->value), KeyOfValue()(z->value))){
+                    if(!comp_(KeyOfValue()(z->value), KeyOfValue()(run.back()->value))){
+                        destroy_node(z);
+                        continue;
+                    }
+                    stray = z;
+                    ++first;
+                    break;
+                }
+                try {
+                    run.push_back(z);
+                } catch (...) {
+                    destroy_node(z);
+                    throw;
+                }
             }
-        }else{
-            y->right = z;
-            if(y == rightmost()){
-                rightmost() = z;
+            merge_sorted_run(run);
+        } catch (...) {
+            for(node_ptr z : run){
+                if(z) destroy_node(z);
             }
+            if(stray) destroy_node(stray);
+            throw;
         }
 
-        insert_rebalance(z, root());
-        ++node_count_;
-        return iterator(z);
+        if(stray && !link_unique(stray)){
+            destroy_node(stray);
+        }
+        for(; first != last; ++first){
+            node_ptr z = create_node(*first);
+            if(!link_unique(z)){
+                destroy_node(z);
+            }
+        }
     }
 
 
@@ -274,6 +373,7 @@ public:
         // Add missing connections
         y->left = x;
         x->parent = y;
+        resize_rotated(x, y);
     }
 
     void rotate_right(node_ptr x, node_ptr& root){
@@ -296,6 +396,7 @@ public:
         // Add missing connections
         y->right = x;
         x->parent = y;
+        resize_rotated(x, y);
     }
 
     void insert_rebalance(node_ptr z, node_ptr& root){
@@ -390,11 +491,13 @@ public:
         // 1.  y determin which node to delete (if z has 2 children, use the intermediate to replace)
         if(z->left == nullptr){
             //std::cout << "z has no left child\n";
+            shrink_path(z->parent);
             x = z->right;
             transplant(z, z->right);
             x_parent = z->parent;
         }else if(z->right == nullptr){
             //std::cout << "z has no right child\n";
+            shrink_path(z->parent);
             x = z->left;
             transplant(z, z->left);
             x_parent = z->parent;
@@ -402,6 +505,7 @@ public:
             //std::cout << "z has two children\n";
             y = minimum(z->right);   // find the intermediate
             y_original_color = y->color;
+            shrink_path(y->parent);
             x = y->right;
             if(y->parent == z){
                 //std::cout << "y is direct child of z\n";
@@ -422,6 +526,7 @@ public:
                 y->left->parent = y;
             }
             y->color = z->color;
+            set_subtree_size(y, subtree_size(z));
         }
 
         // 2 if the deleted is black, break the balance -> fix
@@ -542,7 +647,363 @@ public:
         if (x) x->color = RBTreeColor::Black;
     }
 
-    iterator find(const key_type& key) noexcept{
+    // K is key_type, or any type a transparent Compare orders against
+    // keys; the containers decide which K they let through
+    template <typename K>
+    iterator find(const K& key) {
+        node_ptr n = find_node(key);
+        return n ? iterator(n) : end();
+    }
+
+    template <typename K>
+    bool contains(const K& key) const {return find_node(key) != nullptr;}
+
+    // first element whose key is not before key
+    template <typename K>
+    iterator lower_bound(const K& key) {return iterator(bound_node<false>(key));}
+
+    // first element whose key is after key
+    template <typename K>
+    iterator upper_bound(const K& key) {return iterator(bound_node<true>(key));}
+
+    template <typename K>
+    mystl::pair<iterator, iterator> equal_range(const K& key) {
+        return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+    }
+
+    // elements with keys equivalent to key: O(log n) when Ranked, else
+    // O(log n + count)
+    template <typename K>
+    size_type count(const K& key) const {
+        if constexpr (Ranked){
+            return rank_of<true>(key) - rank_of<false>(key);
+        }else{
+            return count_from(bound_node<false>(key), [&](const Key& k){return !comp_(key, k);});
+        }
+    }
+
+    // elements with keys in [low, high), same cost as count()
+    template <typename K1, typename K2>
+    size_type count_range(const K1& low, const K2& high) const {
+        if(!comp_(low, high)) return 0;
+        if constexpr (Ranked){
+            return rank_of<false>(high) - rank_of<false>(low);
+        }else{
+            return count_from(bound_node<false>(low), [&](const Key& k){return comp_(k, high);});
+        }
+    }
+
+    // number of elements whose key is before key
+    template <typename K>
+    size_type rank(const K& key) const {
+        static_assert(Ranked, "rank() needs a Ranked tree (ranked_rbtree_backend)");
+        return rank_of<false>(key);
+    }
+
+    // the element at index i in key order, end() if i >= size()
+    iterator select(size_type i) {
+        static_assert(Ranked, "select() needs a Ranked tree (ranked_rbtree_backend)");
+        node_ptr x = root();
+        while(x){
+            size_type left = subtree_size(x->left);
+            if(i < left){
+                x = x->left;
+            }else if(i == left){
+                return iterator(x);
+            }else{
+                i -= left + 1;
+                x = x->right;
+            }
+        }
+        return end();
+    }
+
+
+
+private:
+    // hang z under its parent leaf, after any equal keys; keys at or past
+    // rightmost() skip the descent
+    void link_equal(node_ptr z){
+        node_ptr y = header_;
+        bool left = false;
+        if(root() && !comp_(KeyOfValue()(z->value), KeyOfValue()(rightmost()->value))){
+            y = rightmost();
+        }else{
+            for(node_ptr x = root(); x != nullptr;){
+                y = x;
+                left = comp_(KeyOfValue()(z->value), KeyOfValue()(x->value));
+                x = left ? x->left : x->right;
+            }
+        }
+        attach(z, y, left);
+    }
+
+    // where a node with key k would be linked, or the node already holding
+    // k. One descent: the last node not above k is the only candidate for
+    // a duplicate
+    struct unique_pos{
+        node_ptr parent;
+        bool left;
+        node_ptr existing;
+    };
+
+    unique_pos find_unique_pos(const Key& k) const {
+        if(root() && comp_(KeyOfValue()(rightmost()->value), k)){
+            return {rightmost(), false, nullptr};
+        }
+        node_ptr y = header_;
+        node_ptr candidate = nullptr;
+        bool left = false;
+        for(node_ptr x = root(); x != nullptr;){
+            y = x;
+            left = comp_(k, KeyOfValue()(x->value));
+            if(!left) candidate = x;
+            x = left ? x->left : x->right;
+        }
+        if(candidate && !comp_(KeyOfValue()(candidate->value), k)){
+            return {nullptr, false, candidate};
+        }
+        return {y, left, nullptr};
+    }
+
+    // like find_unique_pos, but try the slot right before hint first: if
+    // k falls between hint and its predecessor, one of the two has a free
+    // child slot for it
+    unique_pos find_unique_pos(iterator hint, const Key& k){
+        node_ptr h = hint.cur;
+        if(h == header_){
+            return find_unique_pos(k);
+        }
+        if(comp_(k, KeyOfValue()(h->value))){
+            if(h == leftmost()){
+                return {h, true, nullptr};
+            }
+            node_ptr before = (--hint).cur;
+            if(comp_(KeyOfValue()(before->value), k)){
+                return before->right ? unique_pos{h, true, nullptr} : unique_pos{before, false, nullptr};
+            }
+            return find_unique_pos(k);
+        }
+        if(comp_(KeyOfValue()(h->value), k)){
+            if(h == rightmost()){
+                return {h, false, nullptr};
+            }
+            node_ptr after = (++hint).cur;
+            if(comp_(k, KeyOfValue()(after->value))){
+                return h->right ? unique_pos{after, true, nullptr} : unique_pos{h, false, nullptr};
+            }
+            return find_unique_pos(k);
+        }
+        return {nullptr, false, h};
+    }
+
+    // like link_equal, but leave z out and return false if its key is
+    // already in the tree
+    bool link_unique(node_ptr z){
+        unique_pos pos = find_unique_pos(KeyOfValue()(z->value));
+        if(pos.existing){
+            return false;
+        }
+        attach(z, pos.parent, pos.left);
+        return true;
+    }
+
+    // z becomes the left or right child of y (header_ for an empty tree)
+    void attach(node_ptr z, node_ptr y, bool left){
+        z->parent = y;
+        if(y == header_){
+            root() = z;
+            leftmost() = z;
+            rightmost() = z;
+        }else if(left){
+            y->left = z;
+            if(y == leftmost()){
+                leftmost() = z;
+            }
+        }else{
+            y->right = z;
+            if(y == rightmost()){
+                rightmost() = z;
+            }
+        }
+        if constexpr (Ranked){
+            for(node_ptr p = y; p != header_; p = p->parent){
+                ++static_cast<ranked_node*>(p)->size;
+            }
+        }
+
+        insert_rebalance(z, root());
+        ++node_count_;
+    }
+
+    // add run (sorted, distinct keys, fresh nodes) to the tree. Appends
+    // past rightmost() go one by one, which rebalances in O(1) amortized;
+    // a run into an empty tree, or one large enough to interleave with it,
+    // is merged with the tree's nodes and the lot relinked in O(n + size())
+    void merge_sorted_run(std::vector<node_ptr>& run){
+        if(run.empty()) return;
+        if(!root()){
+            link_sorted(run.data(), run.size());
+            run.clear();
+            return;
+        }
+        if(comp_(KeyOfValue()(rightmost()->value), KeyOfValue()(run.front()->value))){
+            for(node_ptr z : run) attach(z, rightmost(), false);
+            run.clear();
+            return;
+        }
+
+        // descents cost about log2(size()) each
+        size_type depth = 1;
+        while((size_type(1) << depth) < node_count_) ++depth;
+        if(run.size() * depth < node_count_){
+            for(size_type i = 0; i < run.size(); ++i){
+                if(!link_unique(run[i])){
+                    destroy_node(run[i]);
+                }
+                run[i] = nullptr;
+            }
+            run.clear();
+            return;
+        }
+
+        std::vector<node_ptr> all;
+        all.reserve(node_count_ + run.size());
+        iterator it = begin();
+        iterator stop = end();
+        auto fresh = run.begin();
+        while(it != stop && fresh != run.end()){
+            const Key& mine = KeyOfValue()(*it);
+            const Key& theirs = KeyOfValue()((*fresh)->value);
+            if(comp_(theirs, mine)){
+                all.push_back(*fresh++);
+            }else{
+                if(!comp_(mine, theirs)){
+                    destroy_node(*fresh);
+                    *fresh++ = nullptr;
+                }
+                all.push_back(it.cur);
+                ++it;
+            }
+        }
+        for(; it != stop; ++it) all.push_back(it.cur);
+        for(; fresh != run.end(); ++fresh) all.push_back(*fresh);
+        run.clear();
+        link_sorted(all.data(), all.size());
+    }
+
+    // rebuild the tree from the n nodes in key order. Splitting at the
+    // median keeps every leaf within one level of the others, so the full
+    // levels are black and the nodes below them red
+    void link_sorted(node_ptr* nodes, size_type n){
+        size_type full_levels = 0;
+        while((size_type(2) << full_levels) <= n + 1) ++full_levels;
+        root() = build_balanced(nodes, n, 0, full_levels, header_);
+        leftmost() = nodes[0];
+        rightmost() = nodes[n - 1];
+        node_count_ = n;
+    }
+
+    node_ptr build_balanced(node_ptr* nodes, size_type n, size_type depth, size_type red_depth, node_ptr parent){
+        if(n == 0) return nullptr;
+        size_type mid = n / 2;
+        node_ptr x = nodes[mid];
+        x->parent = parent;
+        x->left = build_balanced(nodes, mid, depth + 1, red_depth, x);
+        x->right = build_balanced(nodes + mid + 1, n - mid - 1, depth + 1, red_depth, x);
+        x->color = depth == red_depth ? RBTreeColor::Red : RBTreeColor::Black;
+        set_subtree_size(x, n);
+        return x;
+    }
+
+    // ===== order statistics =====
+    // sizes are only stored (and only cost anything) when Ranked
+
+    static size_type subtree_size(node_ptr x) noexcept {
+        if constexpr (Ranked){
+            return x ? static_cast<ranked_node*>(x)->size : 0;
+        }else{
+            (void)x;
+            return 0;
+        }
+    }
+
+    static void set_subtree_size(node_ptr x, size_type n) noexcept {
+        if constexpr (Ranked){
+            static_cast<ranked_node*>(x)->size = n;
+        }else{
+            (void)x;
+            (void)n;
+        }
+    }
+
+    // y took x's place in a rotation, so it inherits x's old size
+    static void resize_rotated(node_ptr x, node_ptr y) noexcept {
+        if constexpr (Ranked){
+            set_subtree_size(y, subtree_size(x));
+            set_subtree_size(x, subtree_size(x->left) + subtree_size(x->right) + 1);
+        }else{
+            (void)x;
+            (void)y;
+        }
+    }
+
+    // a node is about to be unlinked below p: every subtree up to the
+    // root loses one
+    void shrink_path(node_ptr p) noexcept {
+        if constexpr (Ranked){
+            for(; p != header_; p = p->parent){
+                --static_cast<ranked_node*>(p)->size;
+            }
+        }else{
+            (void)p;
+        }
+    }
+
+    // elements whose key is before key, or not after it when Upper
+    template <bool Upper, typename K>
+    size_type rank_of(const K& key) const {
+        size_type r = 0;
+        for(node_ptr x = root(); x != nullptr;){
+            const Key& k = KeyOfValue()(x->value);
+            if(Upper ? !comp_(key, k) : comp_(k, key)){
+                r += subtree_size(x->left) + 1;
+                x = x->right;
+            }else{
+                x = x->left;
+            }
+        }
+        return r;
+    }
+
+    // lower_bound, or upper_bound when Upper; header_ if there is none
+    template <bool Upper, typename K>
+    node_ptr bound_node(const K& key) const {
+        node_ptr y = header_;
+        for(node_ptr x = root(); x != nullptr;){
+            const Key& k = KeyOfValue()(x->value);
+            if(Upper ? comp_(key, k) : !comp_(k, key)){
+                y = x;
+                x = x->left;
+            }else{
+                x = x->right;
+            }
+        }
+        return y;
+    }
+
+    // walk from x while the keys satisfy in_range
+    template <typename Pred>
+    size_type count_from(node_ptr x, Pred in_range) const {
+        size_type n = 0;
+        for(iterator it(x), stop(header_); it != stop && in_range(KeyOfValue()(*it)); ++it){
+            ++n;
+        }
+        return n;
+    }
+
+    template <typename K>
+    node_ptr find_node(const K& key) const {
         node_ptr cur = root();
         while (cur != nullptr)
         {
@@ -551,15 +1012,11 @@ public:
             else if (comp_(KeyOfValue()(cur->value), key))
                 cur = cur->right;
             else
-                return iterator(cur);
+                return cur;
         }
-        return end();        
-
+        return nullptr;
     }
 
-
-
-private:
     void clear_subtree(node_ptr x){
         if( x == nullptr || x == header_) return;
 
@@ -571,7 +1028,7 @@ private:
 
     // use v to replace u in rbtree
     void transplant(node_ptr u, node_ptr v){
-        if(u->parent == nullptr){   // u is root
+        if(u == root()){   // u is root, its parent is header_
             root() = v;
         }else if(u == u->parent->left){
             u->parent->left = v;
@@ -592,5 +1049,20 @@ private:
 
 };
 
+// default backend tag for the ordered containers (MyMap, MySet,
+// MyMultimap, MyMultiset); see btree_backend in my_btree.h for the other
+struct rbtree_backend{
+    template <typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc>
+    using tree = MyRBTree<Key, Value, KeyOfValue, Compare, Alloc>;
+};
+
+// red-black trees with subtree sizes: rank(), select() and count_range()
+// in O(log n), for one more word per node and an O(log n) walk up on
+// every insert and erase
+struct ranked_rbtree_backend{
+    template <typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc>
+    using tree = MyRBTree<Key, Value, KeyOfValue, Compare, Alloc, true>;
+};
+
 } // namesapce mystl
 #endif // MY_RBTREE_H
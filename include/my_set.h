@@ -2,15 +2,17 @@
 #define MY_SET_H
 
 #include "my_rbtree.h"
+#include "my_btree.h"
 #include "my_utility.h"
 
 namespace mystl{
 
-template <typename Key, typename Compare = std::less<Key>, typename Alloc = mystl::MyAllocator<mystl::RBTreeNode<Key>>>
+template <typename Key, typename Compare = std::less<Key>, typename Alloc = mystl::MyAllocator<mystl::RBTreeNode<Key>>,
+          typename TreeBackend = mystl::rbtree_backend>
 class MySet{
 
 private:
-    using tree_type = mystl::MyRBTree<Key, Key, mystl::identity<Key>, Compare, Alloc>;
+    using tree_type = typename TreeBackend::template tree<Key, Key, mystl::identity<Key>, Compare, Alloc>;
     tree_type tree_;
 
 public:
@@ -22,6 +24,13 @@ public:
 
     MySet() = default;
 
+    // linear time when [first, last) is sorted by key, see insert_sorted
+    template <typename InputIt,
+              typename std::enable_if<mystl::is_input_iterator<InputIt>::value, int>::type = 0>
+    MySet(InputIt first, InputIt last){
+        insert_sorted(first, last);
+    }
+
     bool empty() const noexcept {return tree_.empty();}
     size_type size() const noexcept {return tree_.size();}
 
@@ -30,11 +39,22 @@ public:
     iterator end() noexcept {return tree_.end();}
 
     mystl::pair<iterator, bool> insert(const value_type& value){
-        auto it = tree_.find(value);
-        if(it != tree_.end()) {
-            return {it, false};
-        }
-        return {tree_.insert_equal(value), true};
+        return tree_.insert_unique(value);
+    }
+
+    // hint is the element the new one would go right before, end() for
+    // the largest; amortized O(1) when it is right
+    iterator insert(iterator hint, const value_type& value){
+        return tree_.insert_unique(hint, value);
+    }
+
+    // insert a range sorted by key: into an empty container, or past the
+    // largest key, in O(n) rather than one descent per element. The first
+    // of equal keys wins and keys already present are kept; elements out
+    // of order still go in, one insert at a time
+    template <typename InputIt>
+    void insert_sorted(InputIt first, InputIt last){
+        tree_.insert_sorted_unique(first, last);
     }
 
     void erase(const value_type& value){
@@ -46,8 +66,69 @@ public:
 
     iterator find(const key_type& key) {return tree_.find(key);}
 
+    bool contains(const key_type& key) const {return tree_.contains(key);}
+
+    size_type count(const key_type& key) const {return tree_.contains(key) ? 1 : 0;}
+
+    // ===== range queries =====
+    iterator lower_bound(const key_type& key) {return tree_.lower_bound(key);}
+    iterator upper_bound(const key_type& key) {return tree_.upper_bound(key);}
+
+    mystl::pair<iterator, iterator> equal_range(const key_type& key) {return tree_.equal_range(key);}
+
+    // number of keys in [low, high): O(log n) with ranked_rbtree_backend,
+    // otherwise a walk over the range
+    size_type count_range(const key_type& low, const key_type& high) const {
+        return tree_.count_range(low, high);
+    }
+
+    // order statistics, ranked_rbtree_backend only
+    size_type rank(const key_type& key) const {return tree_.rank(key);}
+    iterator select(size_type i) {return tree_.select(i);}
+
+    // lookups by any type a transparent Compare (e.g. std::less<>) can
+    // order against Key, without converting it to a Key first
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    iterator find(const K& key) {return tree_.find(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    bool contains(const K& key) const {return tree_.contains(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    size_type count(const K& key) const {return tree_.contains(key) ? 1 : 0;}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    iterator lower_bound(const K& key) {return tree_.lower_bound(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    iterator upper_bound(const K& key) {return tree_.upper_bound(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    mystl::pair<iterator, iterator> equal_range(const K& key) {return tree_.equal_range(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Compare>::value, int> = 0>
+    void erase(const K& key){
+        auto it = tree_.find(key);
+        if(it != tree_.end()){
+            tree_.erase(it);
+        }
+    }
+
     void clear() {tree_.clear();}
 
 };
+
+// MySet stored in a B+ tree
+template <typename Key, typename Compare = std::less<Key>>
+using MyBTreeSet = MySet<Key, Compare, mystl::MyAllocator<Key>, mystl::btree_backend<>>;
+
+// MySet with rank() and select()
+template <typename Key, typename Compare = std::less<Key>>
+using MyRankedSet = MySet<Key, Compare, mystl::MyAllocator<mystl::RBTreeNode<Key>>, mystl::ranked_rbtree_backend>;
+
+// MySet whose nodes come from a per-set MyNodePool; see MyPooledMap
+template <typename Key, typename Compare = std::less<Key>>
+using MyPooledSet = MySet<Key, Compare, mystl::MyNodePool<mystl::RBTreeNode<Key>>>;
+
 } // namespace mystl
 #endif // MY_SET_H
\ No newline at end of file
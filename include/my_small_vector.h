@@ -0,0 +1,183 @@
+#ifndef MY_SMALL_VECTOR_H
+#define MY_SMALL_VECTOR_H
+
+#include <cstddef>
+#include <type_traits>
+#include "my_vector.h"
+
+namespace mystl {
+
+// =====================================================
+// MySmallVector: MyVector with room for N elements
+// inside the object. Nothing is allocated until the
+// N + 1-th element arrives; after that it behaves like
+// MyVector, whose growth and insert paths it shares
+// through detail::vector_base. Iterators are the same
+// vector_iterator, so everything in my_algorithm.h
+// works on it unchanged.
+// =====================================================
+template <class T, std::size_t N, class Alloc = MyAllocator<T>, class GrowthPolicy = growth_2x>
+class MySmallVector
+    : public detail::vector_base<MySmallVector<T, N, Alloc, GrowthPolicy>, T, Alloc, GrowthPolicy> {
+    static_assert(N > 0, "MySmallVector needs at least one inline slot");
+
+    using base = detail::vector_base<MySmallVector<T, N, Alloc, GrowthPolicy>, T, Alloc, GrowthPolicy>;
+    friend base;
+
+public:
+    using typename base::value_type;
+    using typename base::size_type;
+    using typename base::const_reference;
+    using typename base::pointer;
+    using typename base::const_pointer;
+
+    static constexpr size_type inline_capacity = N;
+
+private:
+    alignas(T) unsigned char buffer_[sizeof(T) * N];
+
+public:
+    // ==== Constructors ====
+    MySmallVector() noexcept {
+        reset_to_inline();
+    }
+
+    explicit MySmallVector(size_type n, const_reference value = value_type())
+        : MySmallVector() {
+        this->assign(n, value);
+    }
+
+    MySmallVector(std::initializer_list<value_type> ilist)
+        : MySmallVector() {
+        this->append_range(ilist.begin(), ilist.end());
+    }
+
+    template <class InputIt,
+              typename std::enable_if<mystl::is_input_iterator<InputIt>::value, int>::type = 0>
+    MySmallVector(InputIt first, InputIt last)
+        : MySmallVector() {
+        this->append_range(first, last);
+    }
+
+    MySmallVector(const MySmallVector& other)
+        : MySmallVector() {
+        this->append_range(other.begin(), other.end());
+    }
+
+    MySmallVector(MySmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : MySmallVector() {
+        steal(other);
+    }
+
+    MySmallVector& operator=(const MySmallVector& other){
+        if (this != &other) {
+            this->assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    MySmallVector& operator=(MySmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        if (this != &other) {
+            this->clear();
+            this->free_storage();
+            reset_to_inline();
+            steal(other);
+        }
+        return *this;
+    }
+
+    MySmallVector& operator=(std::initializer_list<value_type> ilist){
+        this->assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~MySmallVector() {
+        this->clear();
+        this->free_storage();
+    }
+
+    // true while the elements still live in the inline buffer
+    bool is_inline() const noexcept {
+        return this->start_ == inline_data();
+    }
+
+    // moves back into the inline buffer when the elements fit
+    void shrink_to_fit(){
+        if(this->capacity() == this->size() || is_inline()) return;
+        if(this->size() > N){
+            this->reallocate_to(this->size());
+            return;
+        }
+        pointer heap_start = this->start_;
+        size_type heap_capacity = this->capacity();
+        pointer new_finish = mystl::uninitialized_relocate(this->start_, this->finish_, inline_data(), this->alloc_);
+        this->alloc_.deallocate(heap_start, heap_capacity);
+        this->start_ = inline_data();
+        this->finish_ = new_finish;
+        this->end_of_storage_ = this->start_ + N;
+    }
+
+    // ===== Swap =====
+    // two heap buffers just trade pointers; anything inline has to move
+    void swap(MySmallVector& other) {
+        if (this == &other) return;
+
+        if (!is_inline() && !other.is_inline()) {
+            pointer tmp_start = this->start_;
+            pointer tmp_finish = this->finish_;
+            pointer tmp_end = this->end_of_storage_;
+            this->start_ = other.start_;
+            this->finish_ = other.finish_;
+            this->end_of_storage_ = other.end_of_storage_;
+            other.start_ = tmp_start;
+            other.finish_ = tmp_finish;
+            other.end_of_storage_ = tmp_end;
+            return;
+        }
+
+        MySmallVector tmp(mystl::move(other));
+        other = mystl::move(*this);
+        *this = mystl::move(tmp);
+    }
+
+private:
+    pointer inline_data() noexcept {
+        return reinterpret_cast<pointer>(buffer_);
+    }
+
+    const_pointer inline_data() const noexcept {
+        return reinterpret_cast<const_pointer>(buffer_);
+    }
+
+    bool owns_storage() const noexcept {
+        return !is_inline();
+    }
+
+    void reset_to_inline() noexcept {
+        this->start_ = this->finish_ = inline_data();
+        this->end_of_storage_ = this->start_ + N;
+    }
+
+    // take other's elements: heap buffers are adopted, inline ones relocated
+    // (this must be empty and inline)
+    void steal(MySmallVector& other) {
+        if (!other.is_inline()) {
+            this->start_ = other.start_;
+            this->finish_ = other.finish_;
+            this->end_of_storage_ = other.end_of_storage_;
+            other.reset_to_inline();
+        } else {
+            this->finish_ = mystl::uninitialized_relocate(other.start_, other.finish_, this->start_, this->alloc_);
+            other.finish_ = other.start_;
+        }
+    }
+};
+
+// Non-member swap
+template <class T, std::size_t N, class Alloc, class GrowthPolicy>
+void swap(MySmallVector<T, N, Alloc, GrowthPolicy>& lhs, MySmallVector<T, N, Alloc, GrowthPolicy>& rhs) {
+    lhs.swap(rhs);
+}
+
+}// namesapce mystl
+#endif // MY_SMALL_VECTOR_H
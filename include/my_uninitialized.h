@@ -0,0 +1,157 @@
+#ifndef MY_UNINITIALIZED_H
+#define MY_UNINITIALIZED_H
+
+#include "my_iterator.h"
+#include "my_utility.h"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace mystl{
+
+// ===============================
+// relocation traits
+// ===============================
+
+// a type is trivially relocatable when "move to new address + destroy old"
+// is the same as copying its bytes. Trivially copyable types always are;
+// specialize this for your own types (e.g. a pimpl holding a unique ptr)
+template <class T>
+struct is_trivially_relocatable
+    : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+// move only when it can not throw (or when there is no copy to fall back to),
+// otherwise copy so the source range stays intact if construction throws
+template <class T>
+struct relocate_by_move
+    : std::integral_constant<bool, std::is_nothrow_move_constructible<T>::value ||
+                                   !std::is_copy_constructible<T>::value> {};
+
+// strip vector_iterator down to its pointer so contiguous ranges hit the memcpy paths
+template <class It>
+It unwrap_iterator(It it) { return it; }
+
+template <class T>
+T* unwrap_iterator(vector_iterator<T> it) { return it.base(); }
+
+// ===============================
+// destroy
+// ===============================
+template <class T, class Alloc>
+void destroy(T* first, T* last, Alloc& alloc) noexcept {
+    if constexpr (!std::is_trivially_destructible<T>::value){
+        for(; first != last; ++first){
+            alloc.destroy(first);
+        }
+    }
+}
+
+// ===============================
+// uninitialized_copy
+// ===============================
+// copy-construct [first, last) into the raw memory starting at result and
+// return the end of the destination. Contiguous ranges of trivially copyable
+// elements become a single memcpy. If a constructor throws, the elements
+// already built are destroyed before rethrowing
+template <class InputIt, class T, class Alloc>
+T* uninitialized_copy(InputIt first, InputIt last, T* result, Alloc& alloc){
+    auto ufirst = mystl::unwrap_iterator(first);
+    auto ulast = mystl::unwrap_iterator(last);
+    using src_type = decltype(ufirst);
+
+    if constexpr (std::is_pointer<src_type>::value &&
+                  std::is_same<typename std::remove_cv<typename std::remove_pointer<src_type>::type>::type, T>::value &&
+                  std::is_trivially_copyable<T>::value){
+        std::size_t n = static_cast<std::size_t>(ulast - ufirst);
+        if(n != 0){
+            std::memcpy(static_cast<void*>(result), static_cast<const void*>(ufirst), n * sizeof(T));
+        }
+        return result + n;
+    }else{
+        T* cur = result;
+        try{
+            for(; ufirst != ulast; ++ufirst, ++cur){
+                alloc.construct(cur, *ufirst);
+            }
+        }catch(...){
+            mystl::destroy(result, cur, alloc);
+            throw;
+        }
+        return cur;
+    }
+}
+
+// ===============================
+// uninitialized_move_if_noexcept
+// ===============================
+// build [first, last) at result, moving when relocate_by_move says so and
+// copying otherwise. The source range is not destroyed. On exception the
+// destination is cleaned up and, unless T is a throwing move-only type, the
+// source is unchanged
+template <class T, class Alloc>
+T* uninitialized_move_if_noexcept(T* first, T* last, T* result, Alloc& alloc){
+    if constexpr (!relocate_by_move<T>::value){
+        return mystl::uninitialized_copy(static_cast<const T*>(first), static_cast<const T*>(last), result, alloc);
+    }else{
+        T* cur = result;
+        try{
+            for(; first != last; ++first, ++cur){
+                alloc.construct(cur, mystl::move(*first));
+            }
+        }catch(...){
+            mystl::destroy(result, cur, alloc);
+            throw;
+        }
+        return cur;
+    }
+}
+
+// ===============================
+// uninitialized_relocate
+// ===============================
+// relocate [first, last) into the raw memory starting at result and return
+// the end of the destination range. On return the source range holds no live
+// objects. If an element constructor throws, everything already built in the
+// destination is destroyed and the source range is left as it was (strong
+// guarantee), except for throwing move-only types (basic guarantee).
+template <class T, class Alloc>
+T* uninitialized_relocate(T* first, T* last, T* result, Alloc& alloc){
+    if constexpr (is_trivially_relocatable<T>::value){
+        std::size_t n = static_cast<std::size_t>(last - first);
+        if(n != 0){
+            std::memcpy(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+        }
+        return result + n;
+    }else{
+        T* cur = mystl::uninitialized_move_if_noexcept(first, last, result, alloc);
+        mystl::destroy(first, last, alloc);
+        return cur;
+    }
+}
+
+// relocate [first, mid) to head and [mid, last) to tail, leaving a gap between
+// them in the destination; returns the end of the tail. Same guarantees as
+// uninitialized_relocate: either both halves move or neither does
+template <class T, class Alloc>
+T* uninitialized_relocate_split(T* first, T* mid, T* last, T* head, T* tail, Alloc& alloc){
+    if constexpr (is_trivially_relocatable<T>::value){
+        mystl::uninitialized_relocate(first, mid, head, alloc);
+        return mystl::uninitialized_relocate(mid, last, tail, alloc);
+    }else{
+        T* head_end = mystl::uninitialized_move_if_noexcept(first, mid, head, alloc);
+        T* tail_end = tail;
+        try{
+            tail_end = mystl::uninitialized_move_if_noexcept(mid, last, tail, alloc);
+        }catch(...){
+            mystl::destroy(head, head_end, alloc);
+            throw;
+        }
+        mystl::destroy(first, last, alloc);
+        return tail_end;
+    }
+}
+
+} // namespace mystl
+
+#endif // MY_UNINITIALIZED_H
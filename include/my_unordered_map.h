@@ -3,15 +3,17 @@
 
 
 #include "my_hashtable.h"
+#include "my_node_pool.h"
 
 namespace mystl {
 
 template <
     typename Key,
     typename Value,
-    typename Hash = std::hash<Key>,
+    typename Hash = mystl::hash<Key>,
     typename KeyEqual = mystl::equal_to<Key>,
-    typename Alloc = mystl::MyAllocator<hash_node<Key, Value>>>
+    typename Alloc = mystl::MyAllocator<hash_node<Key, Value>>,
+    typename BucketPolicy = mystl::pow2_bucket_policy>
 class MyUnorderedMap{
 public:
     using key_type = Key;
@@ -19,7 +21,9 @@ public:
     using value_type = mystl::pair<Key, Value>;
     using size_type = std::size_t;
     using allocator_type = Alloc;
-    using table_type = MyHashTable<Key, Value, Hash, KeyEqual, Alloc>;
+    using table_type = MyHashTable<Key, Value, Hash, KeyEqual, Alloc, BucketPolicy>;
+    using iterator = typename table_type::iterator;
+    using const_iterator = typename table_type::const_iterator;
 
 private:
     table_type table_;
@@ -27,6 +31,15 @@ private:
 public:
     explicit MyUnorderedMap(size_type bucket_count = 8)
         : table_(bucket_count) {}
+
+    // bulk construction through build(), see MyHashTable::build
+    template <typename ForwardIt,
+              typename std::enable_if<mystl::is_forward_iterator<ForwardIt>::value, int>::type = 0>
+    MyUnorderedMap(ForwardIt first, ForwardIt last,
+                   duplicate_policy policy = duplicate_policy::last_wins, unsigned threads = 0)
+        : table_() {
+        table_.build(first, last, policy, threads);
+    }
     
     bool empty() const noexcept {return table_.empty();}
 
@@ -34,34 +47,136 @@ public:
 
     size_type bucket_count() const noexcept {return table_.bucket_count();}
 
+    iterator begin() noexcept {return table_.begin();}
+    iterator end() noexcept {return table_.end();}
+    const_iterator begin() const noexcept {return table_.begin();}
+    const_iterator end() const noexcept {return table_.end();}
+    const_iterator cbegin() const noexcept {return table_.cbegin();}
+    const_iterator cend() const noexcept {return table_.cend();}
+
     float load_factor() const noexcept {return table_.load_factor();}
 
+    float max_load_factor() const noexcept {return table_.max_load_factor();}
+    void max_load_factor(float ml) {table_.max_load_factor(ml);}
+
+    // room for n elements without a rehash
+    void reserve(size_type n) {table_.reserve(n);}
+
     void clear() {table_.clear();}
 
+    // insert a range in bulk; returns how many keys were new
+    template <typename ForwardIt>
+    size_type build(ForwardIt first, ForwardIt last,
+                    duplicate_policy policy = duplicate_policy::last_wins, unsigned threads = 0){
+        return table_.build(first, last, policy, threads);
+    }
+
     void insert(const key_type& key, const mapped_type& value){
         table_.insert(key, value);
     }
 
+    // one hash and one chain walk each; see MyHashTable
+    template <typename... Args>
+    mystl::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args){
+        return table_.try_emplace(key, mystl::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    mystl::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args){
+        return table_.try_emplace(mystl::move(key), mystl::forward<Args>(args)...);
+    }
+
+    template <typename M>
+    mystl::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj){
+        return table_.insert_or_assign(key, mystl::forward<M>(obj));
+    }
+
+    template <typename M>
+    mystl::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj){
+        return table_.insert_or_assign(mystl::move(key), mystl::forward<M>(obj));
+    }
+
+    template <typename... Args>
+    mystl::pair<iterator, bool> emplace(Args&&... args){
+        return table_.emplace(mystl::forward<Args>(args)...);
+    }
+
     bool erase(const key_type& key){
         return table_.erase(key);
     }
 
+    iterator erase(const_iterator pos) {return table_.erase(pos);}
+    iterator erase(iterator pos) {return table_.erase(pos);}
+
     mapped_type* find(const key_type& key){
         return table_.find(key);
     }
 
+    const mapped_type* find(const key_type& key) const {
+        return table_.find(key);
+    }
+
+    bool contains(const key_type& key) const {return table_.contains(key);}
+
+    size_type count(const key_type& key) const {return table_.count(key);}
+
+    // lookups by any type Hash and KeyEqual accept, when both are
+    // transparent (e.g. mystl::hash<std::string> with mystl::equal_to<>)
+    template <typename K, std::enable_if_t<transparent_lookup<K, Hash, KeyEqual>::value, int> = 0>
+    mapped_type* find(const K& key){return table_.find(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Hash, KeyEqual>::value, int> = 0>
+    const mapped_type* find(const K& key) const {return table_.find(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Hash, KeyEqual>::value, int> = 0>
+    bool erase(const K& key){return table_.erase(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Hash, KeyEqual>::value, int> = 0>
+    bool contains(const K& key) const {return table_.contains(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Hash, KeyEqual>::value, int> = 0>
+    size_type count(const K& key) const {return table_.count(key);}
+
+    // out[i] = find(keys[i]), with the lookups of a batch overlapped
+    void find_batch(const key_type* keys, size_type n, mapped_type** out){
+        table_.find_batch(keys, n, out);
+    }
+
+    void contains_batch(const key_type* keys, size_type n, bool* out) const {
+        table_.contains_batch(keys, n, out);
+    }
+
     mapped_type& operator[](const key_type& key){
         return table_[key];
     }
 
+    mapped_type& operator[](key_type&& key){
+        return table_[mystl::move(key)];
+    }
+
     void rehash(size_type new_count){
         table_.rehash(new_count);
     }
 
+    void set_incremental_rehash(bool on) noexcept {table_.set_incremental_rehash(on);}
+
+    hash_table_stats stats() const {return table_.stats();}
+
     void print_debug() const {
         table_.print_debug();
     }
 
 };
+
+// MyUnorderedMap whose nodes come from a per-map MyNodePool
+template <
+    typename Key,
+    typename Value,
+    typename Hash = mystl::hash<Key>,
+    typename KeyEqual = mystl::equal_to<Key>,
+    typename BucketPolicy = mystl::pow2_bucket_policy>
+using MyPooledUnorderedMap =
+    MyUnorderedMap<Key, Value, Hash, KeyEqual, MyNodePool<hash_node<Key, Value>>, BucketPolicy>;
+
 } // namespace mystl
 #endif // MY_UNORDERED_MAP
\ No newline at end of file
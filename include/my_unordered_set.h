@@ -2,14 +2,54 @@
 #define MY_UNORDERED_SET
 
 #include "my_hashtable.h"
+#include "my_node_pool.h"
 
 namespace mystl{
 
+// walks the underlying table and yields the keys; elements of a set are
+// never modified in place, so there is no mutable iterator
+template <typename TableIterator, typename Key>
+class unordered_set_iterator{
+public:
+    using iterator_category = mystl::forward_iterator_tag;
+    using value_type = Key;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Key*;
+    using reference = const Key&;
+
+private:
+    TableIterator it_;
+
+public:
+    unordered_set_iterator() = default;
+    explicit unordered_set_iterator(TableIterator it) : it_(it) {}
+
+    reference operator*() const {return it_->first;}
+    pointer operator->() const {return &it_->first;}
+
+    unordered_set_iterator& operator++(){
+        ++it_;
+        return *this;
+    }
+
+    unordered_set_iterator operator++(int){
+        unordered_set_iterator tmp = *this;
+        ++it_;
+        return tmp;
+    }
+
+    bool operator==(const unordered_set_iterator& other) const {return it_ == other.it_;}
+    bool operator!=(const unordered_set_iterator& other) const {return it_ != other.it_;}
+
+    TableIterator base() const {return it_;}
+};
+
 template <
     typename Key,
-    typename Hash = std::hash<Key>,
+    typename Hash = mystl::hash<Key>,
     typename KeyEqual = mystl::equal_to<Key>,
-    typename Alloc = mystl::MyAllocator<hash_node<Key, Key>>>
+    typename Alloc = mystl::MyAllocator<hash_node<Key, Key>>,
+    typename BucketPolicy = mystl::pow2_bucket_policy>
 class MyUnorderedSet{
 public:
     using key_type = Key;
@@ -19,7 +59,9 @@ public:
     using key_equal = KeyEqual;
     using allocator_type = Alloc;
 
-    using table_type = MyHashTable<Key, Key, Hash, KeyEqual, Alloc>;
+    using table_type = MyHashTable<Key, Key, Hash, KeyEqual, Alloc, BucketPolicy>;
+    using const_iterator = unordered_set_iterator<typename table_type::const_iterator, Key>;
+    using iterator = const_iterator;
 
 private:
     table_type table_;
@@ -32,27 +74,71 @@ public:
     size_type size() const noexcept {return table_.size();}
     size_type bucket_count() const noexcept {return table_.bucket_count();}
 
+    const_iterator begin() const noexcept {return const_iterator(table_.begin());}
+    const_iterator end() const noexcept {return const_iterator(table_.end());}
+    const_iterator cbegin() const noexcept {return begin();}
+    const_iterator cend() const noexcept {return end();}
+
     float load_factor() const noexcept {return table_.load_factor();}
 
+    float max_load_factor() const noexcept {return table_.max_load_factor();}
+    void max_load_factor(float ml) {table_.max_load_factor(ml);}
+
+    // room for n elements without a rehash
+    void reserve(size_type n) {table_.reserve(n);}
+
     void clear() {table_.clear();}
 
     void insert(const key_type& key){
         table_.insert(key,key);
     }
 
-    bool contains(const key_type& key) const {
-        return const_cast<table_type&>(table_).find(key) != nullptr;
+    bool contains(const key_type& key) const {return table_.contains(key);}
+
+    size_type count(const key_type& key) const {return table_.count(key);}
+
+    bool erase(const key_type& key){return table_.erase(key);}
+
+    iterator erase(const_iterator pos) {return iterator(table_.erase(pos.base()));}
+
+    // lookups by any type Hash and KeyEqual accept, when both are
+    // transparent (e.g. mystl::hash<std::string> with mystl::equal_to<>)
+    template <typename K, std::enable_if_t<transparent_lookup<K, Hash, KeyEqual>::value, int> = 0>
+    bool contains(const K& key) const {return table_.contains(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Hash, KeyEqual>::value, int> = 0>
+    size_type count(const K& key) const {return table_.count(key);}
+
+    template <typename K, std::enable_if_t<transparent_lookup<K, Hash, KeyEqual>::value, int> = 0>
+    bool erase(const K& key){return table_.erase(key);}
+
+    void contains_batch(const key_type* keys, size_type n, bool* out) const {
+        table_.contains_batch(keys, n, out);
     }
 
     void rehash(size_type new_count){
         table_.rehash(new_count);
     }
 
+    void set_incremental_rehash(bool on) noexcept {table_.set_incremental_rehash(on);}
+
+    hash_table_stats stats() const {return table_.stats();}
+
     void print_debug() const {
         table_.print_debug();
     }
  
 
 };
+
+// MyUnorderedSet whose nodes come from a per-set MyNodePool
+template <
+    typename Key,
+    typename Hash = mystl::hash<Key>,
+    typename KeyEqual = mystl::equal_to<Key>,
+    typename BucketPolicy = mystl::pow2_bucket_policy>
+using MyPooledUnorderedSet =
+    MyUnorderedSet<Key, Hash, KeyEqual, MyNodePool<hash_node<Key, Key>>, BucketPolicy>;
+
 } // namespace mystl
 #endif // MY_UNORDERED_SET
\ No newline at end of file
@@ -1,6 +1,20 @@
 #ifndef MY_UTILITY_H
 #define MY_UTILITY_H
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
 namespace mystl{
 
 // remove_reference
@@ -69,25 +83,65 @@ struct identity{
 };
 
 // less: default comparator (a < b)
-template <class T>
+template <class T = void>
 struct less{
     bool operator()(const T& lhs, const  T& rhs) const noexcept{
         return lhs < rhs;
     }
 };
 
+// less<>: compares any two types, and marks ordered containers as
+// accepting lookups by key-compatible types
+template <>
+struct less<void>{
+    using is_transparent = void;
+
+    template <class T, class U>
+    constexpr bool operator()(const T& lhs, const U& rhs) const {
+        return lhs < rhs;
+    }
+};
+
 // equal_to: returns lhs == rhs
-template <class T>
+template <class T = void>
 struct equal_to {
     constexpr bool operator()(const T& lhs, const T& rhs) const noexcept {
         return lhs == rhs;
     }
 };
 
+// equal_to<>: the transparent counterpart for the hash containers
+template <>
+struct equal_to<void>{
+    using is_transparent = void;
+
+    template <class T, class U>
+    constexpr bool operator()(const T& lhs, const U& rhs) const {
+        return lhs == rhs;
+    }
+};
+
+// true when F declares is_transparent (heterogeneous lookup)
+template <class F, class = void>
+struct is_transparent : std::false_type {};
+
+template <class F>
+struct is_transparent<F, std::void_t<typename F::is_transparent>> : std::true_type {};
+
+// whether a container whose functors are F... may look up a K directly.
+// K only makes the condition dependent, so member templates guarded by it
+// drop out of overload resolution instead of failing to compile
+template <class K, class... F>
+struct transparent_lookup : std::conjunction<is_transparent<F>...> {};
+
 
 // ==============================
 // my pair
 // ==============================
+// tag for building each member of a pair from its own argument tuple
+struct piecewise_construct_t { explicit piecewise_construct_t() = default; };
+inline constexpr piecewise_construct_t piecewise_construct{};
+
 template <typename T1, typename T2>
 struct pair {
     using first_type = T1;
@@ -109,6 +163,11 @@ struct pair {
     constexpr pair(const pair<U1, U2>& other)
         : first(other.first), second(other.second) {}
 
+    // first(args1...), second(args2...): no temporary for either member
+    template <typename... Args1, typename... Args2>
+    pair(piecewise_construct_t, std::tuple<Args1...> args1, std::tuple<Args2...> args2)
+        : pair(args1, args2, std::index_sequence_for<Args1...>(), std::index_sequence_for<Args2...>()) {}
+
     // Copy and move
     pair(const pair&) = default;
     pair(pair&&) noexcept = default;
@@ -139,6 +198,12 @@ struct pair {
     constexpr bool operator>=(const pair& other) const {
         return !(*this<other);
     }
+
+private:
+    template <typename Tuple1, typename Tuple2, std::size_t... I1, std::size_t... I2>
+    pair(Tuple1& args1, Tuple2& args2, std::index_sequence<I1...>, std::index_sequence<I2...>)
+        : first(std::forward<std::tuple_element_t<I1, Tuple1>>(std::get<I1>(args1))...),
+          second(std::forward<std::tuple_element_t<I2, Tuple2>>(std::get<I2>(args2))...) {}
 };
 
 // ===============================
@@ -154,6 +219,188 @@ constexpr pair<T1, T2> make_pair(T1&& a, T2&& b){
 // ===============================
 // my hash func
 // ===============================
+// mystl::hash<T> is the default hasher of the unordered containers. Its
+// output is fully mixed (declared with `is_avalanching`), so tables can
+// index with the low or high bits directly:
+//   - integers, enums and pointers go through a one-multiply finalizer
+//   - strings use a wyhash-style byte hash that reads 8 bytes at a time and
+//     runs three independent multiply lanes over long inputs
+//   - anything else falls back to std::hash<T> and is finalized, so user
+//     specializations of std::hash keep working
+// Heterogeneous lookup: hash<std::string> and hash<std::string_view> are
+// transparent and hash std::string, std::string_view and const char* to the
+// same value. hash<void> hashes whatever it is given with hash<decay_t<U>>,
+// routing string-like arguments through std::string_view.
+
+// 64 x 64 -> 128 bit multiply, returns the low half and stores the high
+inline std::uint64_t mul_u64_wide(std::uint64_t a, std::uint64_t b, std::uint64_t& hi) noexcept {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    uint128 r = static_cast<uint128>(a) * b;
+    hi = static_cast<std::uint64_t>(r >> 64);
+    return static_cast<std::uint64_t>(r);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, &hi);
+#else
+    std::uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+    std::uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+    std::uint64_t lo_lo = a_lo * b_lo;
+    std::uint64_t hi_lo = a_hi * b_lo;
+    std::uint64_t lo_hi = a_lo * b_hi;
+    std::uint64_t hi_hi = a_hi * b_hi;
+    std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+    hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+#endif
+}
+
+// fold the 128-bit product of a and b into 64 bits
+inline std::uint64_t hash_mix(std::uint64_t a, std::uint64_t b) noexcept {
+    std::uint64_t hi;
+    std::uint64_t lo = mul_u64_wide(a, b, hi);
+    return lo ^ hi;
+}
+
+namespace detail{
+
+constexpr std::uint64_t hash_secret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+    0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+inline std::uint64_t hash_read8(const unsigned char* p) noexcept {
+    std::uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline std::uint64_t hash_read4(const unsigned char* p) noexcept {
+    std::uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+// 1..3 bytes: first, middle and last byte
+inline std::uint64_t hash_read3(const unsigned char* p, std::size_t len) noexcept {
+    return (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[len >> 1]) << 8) | p[len - 1];
+}
+
+} // namespace detail
+
+// integer finalizer
+inline std::size_t hash_int(std::uint64_t x) noexcept {
+    return static_cast<std::size_t>(hash_mix(x ^ detail::hash_secret[0], detail::hash_secret[1]));
+}
+
+// wyhash-style byte hash
+inline std::size_t hash_bytes(const void* data, std::size_t len, std::uint64_t seed = 0) noexcept {
+    using detail::hash_secret;
+    using detail::hash_read8;
+    using detail::hash_read4;
+
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    seed ^= hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+    std::uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            std::size_t mid = (len >> 3) << 2;
+            a = (hash_read4(p) << 32) | hash_read4(p + mid);
+            b = (hash_read4(p + len - 4) << 32) | hash_read4(p + len - 4 - mid);
+        } else if (len > 0) {
+            a = detail::hash_read3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        std::size_t i = len;
+        if (i > 48) {
+            // three independent lanes so the multiplies overlap
+            std::uint64_t lane1 = seed, lane2 = seed;
+            do {
+                seed = hash_mix(hash_read8(p) ^ hash_secret[1], hash_read8(p + 8) ^ seed);
+                lane1 = hash_mix(hash_read8(p + 16) ^ hash_secret[2], hash_read8(p + 24) ^ lane1);
+                lane2 = hash_mix(hash_read8(p + 32) ^ hash_secret[3], hash_read8(p + 40) ^ lane2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (i > 16) {
+            seed = hash_mix(hash_read8(p) ^ hash_secret[1], hash_read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = hash_read8(p + i - 16);
+        b = hash_read8(p + i - 8);
+    }
+    std::uint64_t hi;
+    std::uint64_t lo = mul_u64_wide(a ^ hash_secret[1], b ^ seed, hi);
+    return static_cast<std::size_t>(hash_mix(lo ^ hash_secret[0] ^ len, hi ^ hash_secret[1]));
+}
+
+// combine a value's hash into a running seed, for hashing aggregates
+inline std::size_t hash_combine(std::size_t seed, std::size_t h) noexcept {
+    return static_cast<std::size_t>(hash_mix(seed ^ detail::hash_secret[2], h ^ detail::hash_secret[3]));
+}
+
+template <class T>
+struct hash{
+    using is_avalanching = void;
+
+    std::size_t operator()(const T& x) const noexcept(noexcept(std::hash<T>{}(x))) {
+        if constexpr (std::is_enum<T>::value) {
+            return hash_int(static_cast<std::uint64_t>(x));
+        } else if constexpr (std::is_integral<T>::value) {
+            return hash_int(static_cast<std::uint64_t>(x));
+        } else if constexpr (std::is_pointer<T>::value) {
+            return hash_int(reinterpret_cast<std::uintptr_t>(x));
+        } else if constexpr (std::is_floating_point<T>::value) {
+            // +0.0 and -0.0 compare equal, so they must hash equal
+            if (x == T(0)) return hash_int(0);
+            if constexpr (sizeof(T) <= 8) return hash_bytes(&x, sizeof(T));
+            else return hash_int(static_cast<std::uint64_t>(std::hash<T>{}(x)));
+        } else {
+            return hash_int(static_cast<std::uint64_t>(std::hash<T>{}(x)));
+        }
+    }
+};
+
+template <class CharT, class Traits, class Alloc>
+struct hash<std::basic_string<CharT, Traits, Alloc>>{
+    using is_avalanching = void;
+    using is_transparent = void;
+
+    std::size_t operator()(std::basic_string_view<CharT, Traits> s) const noexcept {
+        return hash_bytes(s.data(), s.size() * sizeof(CharT));
+    }
+};
+
+template <class CharT, class Traits>
+struct hash<std::basic_string_view<CharT, Traits>>
+    : hash<std::basic_string<CharT, Traits>> {};
+
+template <>
+struct hash<void>{
+    using is_avalanching = void;
+    using is_transparent = void;
+
+    template <class U>
+    std::size_t operator()(const U& x) const {
+        if constexpr (std::is_convertible<const U&, std::string_view>::value) {
+            return hash<std::string_view>{}(std::string_view(x));
+        } else {
+            return hash<typename std::decay<U>::type>{}(x);
+        }
+    }
+};
+
+// true when Hash promises well-mixed output (declares is_avalanching), so a
+// table can skip its own mixing step
+template <class Hash, class = void>
+struct hash_is_avalanching : std::false_type {};
+
+template <class Hash>
+struct hash_is_avalanching<Hash, std::void_t<typename Hash::is_avalanching>> : std::true_type {};
 
 
 } // namespace mystl
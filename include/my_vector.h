@@ -3,17 +3,35 @@
 
 #include <stdexcept>
 #include <memory>
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
 #include "my_allocator.h"
+#include "my_growth_policy.h"
 #include "my_iterator.h"
 #include "my_utility.h"
+#include "my_uninitialized.h"
+#include "my_algorithm.h"
 
 namespace mystl {
 
-template <class T, class Alloc = MyAllocator<T>>
-class MyVector {
+namespace detail {
+
+// =====================================================
+// vector_base: everything MyVector and MySmallVector
+// share, written against the start_ / finish_ /
+// end_of_storage_ triple. Where the first block comes
+// from is the derived class's business: it tells the
+// base through owns_storage() whether the current block
+// was allocated (and must be freed when replaced), and
+// takes care of construction, moves and swap itself.
+// =====================================================
+template <class Derived, class T, class Alloc, class GrowthPolicy>
+class vector_base {
 public:
     using value_type = T;
     using allocator_type = Alloc;
+    using growth_policy = GrowthPolicy;
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
     using reference = value_type&;
@@ -25,42 +43,19 @@ public:
     using reverse_iterator = mystl::reverse_iterator<iterator>;
     using const_reverse_iterator = mystl::reverse_iterator<const_iterator>;
 
-private:
+protected:
     allocator_type alloc_;
-    pointer start_;
-    pointer finish_;
-    pointer end_of_storage_;
-
-public:
-    // ==== Constructors ====
-    MyVector() : start_(nullptr), finish_(nullptr), end_of_storage_(nullptr) {};
-
-    explicit MyVector(size_type n, const_reference value = value_type())
-        : start_(alloc_.allocate(n)),
-          finish_(start_),
-          end_of_storage_(start_ + n) {
-        std::uninitialized_fill_n(start_, n, value);
-        finish_ = end_of_storage_;
-    }
-
-    MyVector(std::initializer_list<value_type> ilist){
-        start_ = alloc_.allocate(ilist.size());
-        finish_ = start_;
-        end_of_storage_ = start_ + ilist.size();
-        for (const auto& item : ilist) {
-            alloc_.construct(finish_, item);
-            ++finish_;
-        }
-    }
+    pointer start_{nullptr};
+    pointer finish_{nullptr};
+    pointer end_of_storage_{nullptr};
 
-    ~MyVector() {
-        clear();
-        if (start_) {
-            alloc_.deallocate(start_, end_of_storage_ - start_);
-        }
-    }
+    vector_base() = default;
+    ~vector_base() = default;
 
+    vector_base(const vector_base&) = delete;
+    vector_base& operator=(const vector_base&) = delete;
 
+public:
     // ===== Baisc Member Functions =====
     size_type size() const noexcept {
         return static_cast<size_type>(finish_ - start_);
@@ -74,6 +69,9 @@ public:
         return start_ == finish_;
     }
 
+    pointer data() noexcept { return start_; }
+    const_pointer data() const noexcept { return start_; }
+
     reference operator[](size_type i) noexcept {
         return start_[i];
     }
@@ -89,13 +87,176 @@ public:
         return start_[i];
     }
 
+    reference front(){
+        if(empty()){
+            throw std::out_of_range("Vector is empty");
+        }
+        return *start_;
+    }
+
+    reference back(){
+        if(empty()){
+            throw std::out_of_range("Vector is empty");
+        }
+        return *(finish_ - 1);
+    }
+
+    const_reference back() const {
+        if(empty()){
+            throw std::out_of_range("Vector is empty");
+        }
+        return *(finish_ - 1);
+    }
 
     void push_back(const_reference value) {
+        emplace_back(value);
+    }
+
+    void push_back(value_type&& value) {
+        emplace_back(mystl::move(value));
+    }
+
+    // construct the element in place at the end
+    template <class... Args>
+    reference emplace_back(Args&&... args) {
+        if (finish_ != end_of_storage_) {
+            alloc_.construct(finish_, mystl::forward<Args>(args)...);
+            ++finish_;
+        } else {
+            realloc_emplace_back(mystl::forward<Args>(args)...);
+        }
+        return *(finish_ - 1);
+    }
+
+    // construct the element in place before pos
+    template <class... Args>
+    iterator emplace(iterator pos, Args&&... args) {
+        size_type index = static_cast<size_type>(pos.base() - start_);
+        if (pos.base() == finish_) {
+            emplace_back(mystl::forward<Args>(args)...);
+            return iterator(start_ + index);
+        }
+
+        // args may refer to an element of this vector: build the value first
+        value_type tmp(mystl::forward<Args>(args)...);
         if (finish_ == end_of_storage_) {
-            reallocate();
+            reallocate_to(next_capacity(size() + 1));
         }
-        alloc_.construct(finish_, value);
+
+        pointer p = start_ + index;
+        alloc_.construct(finish_, mystl::move(*(finish_ - 1)));
         ++finish_;
+        mystl::move_backward(p, finish_ - 2, finish_ - 1);
+        *p = mystl::move(tmp);
+        return iterator(p);
+    }
+
+    iterator insert(iterator pos, const_reference value) {
+        return emplace(pos, value);
+    }
+
+    iterator insert(iterator pos, value_type&& value) {
+        return emplace(pos, mystl::move(value));
+    }
+
+    // ===== Range Insert / Assign =====
+    // insert [first, last) before pos. Forward ranges are measured once and
+    // copied in bulk, input ranges are appended and rotated into place
+    template <class InputIt,
+              typename std::enable_if<mystl::is_input_iterator<InputIt>::value, int>::type = 0>
+    iterator insert(iterator pos, InputIt first, InputIt last) {
+        size_type index = static_cast<size_type>(pos.base() - start_);
+        if constexpr (mystl::is_forward_iterator<InputIt>::value) {
+            size_type n = static_cast<size_type>(mystl::distance(first, last));
+            range_insert(start_ + index, first, last, n);
+        } else {
+            size_type old_size = size();
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+            mystl::rotate(start_ + index, start_ + old_size, finish_);
+        }
+        return iterator(start_ + index);
+    }
+
+    iterator insert(iterator pos, std::initializer_list<value_type> ilist) {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    // append [first, last) at the end
+    template <class InputIt,
+              typename std::enable_if<mystl::is_input_iterator<InputIt>::value, int>::type = 0>
+    void append_range(InputIt first, InputIt last) {
+        insert(end(), first, last);
+    }
+
+    // replace the contents with [first, last), reusing the buffer when it
+    // fits; a range that does not is built in a new block first
+    template <class InputIt,
+              typename std::enable_if<mystl::is_input_iterator<InputIt>::value, int>::type = 0>
+    void assign(InputIt first, InputIt last) {
+        if constexpr (mystl::is_forward_iterator<InputIt>::value) {
+            size_type n = static_cast<size_type>(mystl::distance(first, last));
+            if (n > capacity()) {
+                size_type new_cap = n;
+                pointer new_start = allocate_storage(new_cap);
+                pointer new_finish = new_start;
+                try {
+                    new_finish = mystl::uninitialized_copy(first, last, new_start, alloc_);
+                } catch (...) {
+                    alloc_.deallocate(new_start, new_cap);
+                    throw;
+                }
+                clear();
+                adopt(new_start, new_finish, new_cap);
+            } else if (n <= size()) {
+                pointer new_finish = mystl::copy(first, last, start_);
+                destroy_at_end(new_finish);
+            } else {
+                InputIt mid = first;
+                mystl::advance(mid, static_cast<difference_type>(size()));
+                mystl::copy(first, mid, start_);
+                finish_ = mystl::uninitialized_copy(mid, last, finish_, alloc_);
+            }
+        } else {
+            pointer cur = start_;
+            for (; first != last && cur != finish_; ++first, ++cur) {
+                *cur = *first;
+            }
+            if (first == last) {
+                destroy_at_end(cur);
+            } else {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            }
+        }
+    }
+
+    // value may be an element of this vector
+    void assign(size_type n, const_reference value) {
+        if (n > capacity()) {
+            size_type new_cap = n;
+            pointer new_start = allocate_storage(new_cap);
+            try {
+                std::uninitialized_fill_n(new_start, n, value);
+            } catch (...) {
+                alloc_.deallocate(new_start, new_cap);
+                throw;
+            }
+            clear();
+            adopt(new_start, new_start + n, new_cap);
+        } else if (n <= size()) {
+            mystl::fill(start_, start_ + n, value);
+            destroy_at_end(start_ + n);
+        } else {
+            mystl::fill(start_, finish_, value);
+            finish_ = std::uninitialized_fill_n(finish_, n - size(), value);
+        }
+    }
+
+    void assign(std::initializer_list<value_type> ilist) {
+        assign(ilist.begin(), ilist.end());
     }
 
     void pop_back() {
@@ -106,18 +267,8 @@ public:
         alloc_.destroy(finish_);
     }
 
-    value_type back(){
-        if(empty()){
-            throw std::out_of_range("Vecotr is empty");
-        }
-        return start_[size()-1];
-    }
-
     void clear() noexcept {
-        while (finish_ != start_) {
-            --finish_;
-            alloc_.destroy(finish_);
-        }
+        destroy_at_end(start_);
     }
 
     void reserve(size_type new_cap) {
@@ -132,28 +283,19 @@ public:
         size_type old_size = size();
 
         if(new_size < old_size){
-            //destroy extra elements
-            while(finish_ != start_ + new_size){
-                --finish_;
-                alloc_.destroy(finish_);
-            }
+            destroy_at_end(start_ + new_size);
         }else if(new_size > old_size){
             if(new_size > capacity()){
-                reallocate_to(std::max(new_size, capacity() * 2));
-            }
-            //construct new elements
-            while(finish_ != start_ + new_size){
-                alloc_.construct(finish_, value);
-                ++finish_;
+                // value may live in the block about to be released
+                value_type tmp(value);
+                reallocate_to(next_capacity(new_size));
+                finish_ = std::uninitialized_fill_n(finish_, new_size - old_size, tmp);
+            }else{
+                finish_ = std::uninitialized_fill_n(finish_, new_size - old_size, value);
             }
         }
     }
 
-    void shrink_to_fit(){
-        if(capacity() == size()) return;
-        reallocate_to(size());
-    }
-
 
     // ===== Iterator Support =====
     iterator begin() noexcept {
@@ -188,78 +330,262 @@ public:
         return const_reverse_iterator(const_iterator(start_));
     }
 
-    // ===== Swap (no std::swap) =====
-    void swap(MyVector& other) noexcept {
-        if (this == &other) return;
+protected:
+    // build from [first, last) in a constructor whose destructor will not
+    // run if this throws (not a delegating one): nothing is left behind
+    template <class InputIt>
+    void init_range(InputIt first, InputIt last) {
+        try {
+            append_range(first, last);
+        } catch (...) {
+            clear();
+            free_storage();
+            throw;
+        }
+    }
 
-        pointer tmp_start = start_;
-        start_ = other.start_;
-        other.start_ = tmp_start;
+    // give the current block back if it was allocated; the pointers are
+    // left for the caller to reset
+    void free_storage() noexcept {
+        if (static_cast<const Derived&>(*this).owns_storage()) {
+            alloc_.deallocate(start_, capacity());
+        }
+    }
 
-        pointer tmp_finish = finish_;
-        finish_ = other.finish_;
-        other.finish_ = tmp_finish;
+    // replace the (already emptied) current block with an allocated one
+    void adopt(pointer new_start, pointer new_finish, size_type new_cap) noexcept {
+        free_storage();
+        start_ = new_start;
+        finish_ = new_finish;
+        end_of_storage_ = start_ + new_cap;
+    }
 
-        pointer tmp_end = end_of_storage_;
-        end_of_storage_ = other.end_of_storage_;
-        other.end_of_storage_ = tmp_end;
+    // capacity to grow to when at least required elements must fit
+    size_type next_capacity(size_type required) const noexcept {
+        return GrowthPolicy::grow(capacity(), required);
+    }
 
-        allocator_type tmp_alloc = mystl::move(alloc_);
-        alloc_ = mystl::move(other.alloc_);
-        other.alloc_ = mystl::move(tmp_alloc);
+    // allocate room for at least n elements; n becomes the real capacity,
+    // including any slack the allocator's size class gives us
+    pointer allocate_storage(size_type& n){
+        auto result = mystl::allocate_at_least(alloc_, n);
+        n = result.count;
+        return result.ptr;
+    }
+
+    void destroy_at_end(pointer new_finish) noexcept {
+        mystl::destroy(new_finish, finish_, alloc_);
+        finish_ = new_finish;
+    }
+
+    // relocate the elements into a fresh block (memcpy for trivially
+    // relocatable types) and release the old one
+    void reallocate_to(size_type new_cap){
+        pointer new_start = allocate_storage(new_cap);
+        pointer new_finish = new_start;
+
+        try{
+            new_finish = mystl::uninitialized_relocate(start_, finish_, new_start, alloc_);
+        }catch(...){
+            alloc_.deallocate(new_start, new_cap);
+            throw;
+        }
+
+        adopt(new_start, new_finish, new_cap);
     }
 
 private:
-    void reallocate(){
+    // insert n elements from [first, last) before pos
+    template <class ForwardIt>
+    void range_insert(pointer pos, ForwardIt first, ForwardIt last, size_type n) {
+        if (n == 0) return;
+
+        if (static_cast<size_type>(end_of_storage_ - finish_) >= n) {
+            // enough room: open a gap of n at pos by shifting the tail
+            size_type elems_after = static_cast<size_type>(finish_ - pos);
+            pointer old_finish = finish_;
+            if (elems_after > n) {
+                finish_ = mystl::uninitialized_move_if_noexcept(finish_ - n, finish_, finish_, alloc_);
+                mystl::move_backward(pos, old_finish - n, old_finish);
+                mystl::copy(first, last, pos);
+            } else {
+                ForwardIt mid = first;
+                mystl::advance(mid, static_cast<difference_type>(elems_after));
+                finish_ = mystl::uninitialized_copy(mid, last, finish_, alloc_);
+                try {
+                    finish_ = mystl::uninitialized_move_if_noexcept(pos, old_finish, finish_, alloc_);
+                } catch (...) {
+                    destroy_at_end(old_finish);
+                    throw;
+                }
+                mystl::copy(first, mid, pos);
+            }
+            return;
+        }
+
+        // not enough room: build the new elements in a fresh block first,
+        // then relocate the old ones around them (old block untouched on throw)
+        size_type index = static_cast<size_type>(pos - start_);
+        size_type new_cap = next_capacity(size() + n);
+        pointer new_start = allocate_storage(new_cap);
+        pointer gap = new_start + index;
+        pointer new_finish = new_start;
+
+        try {
+            mystl::uninitialized_copy(first, last, gap, alloc_);
+        } catch (...) {
+            alloc_.deallocate(new_start, new_cap);
+            throw;
+        }
+
+        try {
+            new_finish = mystl::uninitialized_relocate_split(start_, pos, finish_, new_start, gap + n, alloc_);
+        } catch (...) {
+            mystl::destroy(gap, gap + n, alloc_);
+            alloc_.deallocate(new_start, new_cap);
+            throw;
+        }
+
+        adopt(new_start, new_finish, new_cap);
+    }
 
+    // grow while appending: the new element is built in the new block before
+    // the old elements are relocated, so args may alias an element of *this.
+    // Strong guarantee: on exception the vector is left untouched
+    template <class... Args>
+    void realloc_emplace_back(Args&&... args){
         size_type old_size = size();
-        size_type old_capacity = capacity();
-        size_type new_capacity = old_capacity == 0 ? 1 : old_capacity * 2;
+        size_type new_cap = next_capacity(old_size + 1);
 
-        pointer new_start = alloc_.allocate(new_capacity);
+        pointer new_start = allocate_storage(new_cap);
         pointer new_finish = new_start;
 
-        //move old data to new memory
-        for(pointer p = start_; p != finish_; ++p, ++new_finish){
-            alloc_.construct(new_finish, std::move(*p));
-            alloc_.destroy(p);
+        try{
+            alloc_.construct(new_start + old_size, mystl::forward<Args>(args)...);
+        }catch(...){
+            alloc_.deallocate(new_start, new_cap);
+            throw;
         }
 
-        if(start_){
-            alloc_.deallocate(start_, old_capacity);
+        try{
+            new_finish = mystl::uninitialized_relocate(start_, finish_, new_start, alloc_);
+        }catch(...){
+            alloc_.destroy(new_start + old_size);
+            alloc_.deallocate(new_start, new_cap);
+            throw;
         }
+        ++new_finish;
 
+        adopt(new_start, new_finish, new_cap);
+    }
+};
 
-        start_ = new_start;
-        finish_ = new_finish;
-        end_of_storage_ = start_ + new_capacity;
+} // namespace detail
+
+template <class T, class Alloc = MyAllocator<T>, class GrowthPolicy = growth_2x>
+class MyVector : public detail::vector_base<MyVector<T, Alloc, GrowthPolicy>, T, Alloc, GrowthPolicy> {
+    using base = detail::vector_base<MyVector<T, Alloc, GrowthPolicy>, T, Alloc, GrowthPolicy>;
+    friend base;
+
+public:
+    using typename base::value_type;
+    using typename base::allocator_type;
+    using typename base::size_type;
+    using typename base::const_reference;
+    using typename base::pointer;
+
+    // ==== Constructors ====
+    MyVector() = default;
+
+    explicit MyVector(size_type n, const_reference value = value_type()) {
+        this->assign(n, value);
     }
 
-    void reallocate_to(size_type new_cap){
-        size_type old_size = size();
-        pointer new_start = alloc_.allocate(new_cap);
-        pointer new_finish = new_start;
+    MyVector(std::initializer_list<value_type> ilist) {
+        this->init_range(ilist.begin(), ilist.end());
+    }
+
+    // build from [first, last): forward ranges allocate exactly once
+    template <class InputIt,
+              typename std::enable_if<mystl::is_input_iterator<InputIt>::value, int>::type = 0>
+    MyVector(InputIt first, InputIt last) {
+        this->init_range(first, last);
+    }
+
+    MyVector(const MyVector& other) : base() {
+        this->init_range(other.begin(), other.end());
+    }
+
+    MyVector(MyVector&& other) noexcept {
+        this->start_ = other.start_;
+        this->finish_ = other.finish_;
+        this->end_of_storage_ = other.end_of_storage_;
+        other.start_ = other.finish_ = other.end_of_storage_ = nullptr;
+    }
 
-        //move old data to new memory
-        for(pointer p = start_; p != finish_; ++p, ++new_finish){
-            alloc_.construct(new_finish, std::move(*p));
-            alloc_.destroy(p);
+    MyVector& operator=(const MyVector& other){
+        if (this != &other) {
+            this->assign(other.begin(), other.end());
         }
+        return *this;
+    }
+
+    MyVector& operator=(MyVector&& other) noexcept {
+        MyVector tmp(mystl::move(other));
+        swap(tmp);
+        return *this;
+    }
+
+    MyVector& operator=(std::initializer_list<value_type> ilist){
+        this->assign(ilist.begin(), ilist.end());
+        return *this;
+    }
 
-        //free old memory
-        if(start_){
-            alloc_.deallocate(start_, old_size);
+    ~MyVector() {
+        this->clear();
+        this->free_storage();
+    }
+
+    void shrink_to_fit(){
+        if(this->capacity() == this->size()) return;
+        if(this->empty()){
+            this->free_storage();
+            this->start_ = this->finish_ = this->end_of_storage_ = nullptr;
+            return;
         }
+        this->reallocate_to(this->size());
+    }
 
-        start_ = new_start;
-        finish_ = new_finish;
-        end_of_storage_ = start_ + new_cap;
+    // ===== Swap (no std::swap) =====
+    void swap(MyVector& other) noexcept {
+        if (this == &other) return;
+
+        pointer tmp_start = this->start_;
+        this->start_ = other.start_;
+        other.start_ = tmp_start;
+
+        pointer tmp_finish = this->finish_;
+        this->finish_ = other.finish_;
+        other.finish_ = tmp_finish;
+
+        pointer tmp_end = this->end_of_storage_;
+        this->end_of_storage_ = other.end_of_storage_;
+        other.end_of_storage_ = tmp_end;
+
+        allocator_type tmp_alloc = mystl::move(this->alloc_);
+        this->alloc_ = mystl::move(other.alloc_);
+        other.alloc_ = mystl::move(tmp_alloc);
+    }
+
+private:
+    bool owns_storage() const noexcept {
+        return this->start_ != nullptr;
     }
 };
 
 // Non-member swap
-template <class T, class Alloc>
-void swap(MyVector<T, Alloc>& lhs, MyVector<T, Alloc>& rhs) noexcept {
+template <class T, class Alloc, class GrowthPolicy>
+void swap(MyVector<T, Alloc, GrowthPolicy>& lhs, MyVector<T, Alloc, GrowthPolicy>& rhs) noexcept {
     lhs.swap(rhs);
 }
 
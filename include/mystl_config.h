@@ -6,6 +6,60 @@
 
 #define MYSTL_VERSION "0.1.0"
 
+// MYSTL_HAS_MALLOC_USABLE_SIZE: define it to 1 to let MyAllocator ask the C
+// allocator (malloc_usable_size, malloc_size or _msize) how many bytes a
+// block really holds, so allocate_at_least reports the size-class slack.
+// Off by default: glibc documents writing into that slack as unsupported,
+// and _FORTIFY_SOURCE=3 or a sanitizer reports it as an overflow.
+#ifndef MYSTL_HAS_MALLOC_USABLE_SIZE
+#define MYSTL_HAS_MALLOC_USABLE_SIZE 0
+#endif
+
+// MYSTL_HAS_SSE2 / MYSTL_HAS_AVX2: SIMD paths used by the flat hash map to
+// scan a group of control bytes at once. Define MYSTL_NO_SIMD to force the
+// portable byte loop.
+#if !defined(MYSTL_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MYSTL_HAS_SSE2 1
+#else
+#define MYSTL_HAS_SSE2 0
+#endif
+
+#if !defined(MYSTL_NO_SIMD) && defined(__AVX2__)
+#define MYSTL_HAS_AVX2 1
+#else
+#define MYSTL_HAS_AVX2 0
+#endif
+
+// MYSTL_PREFETCH(addr): hint that addr will be read soon. A no-op where the
+// compiler has no prefetch builtin.
+#if defined(__GNUC__) || defined(__clang__)
+#define MYSTL_PREFETCH(addr) __builtin_prefetch(static_cast<const void*>(addr))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define MYSTL_PREFETCH(addr) _mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
+#else
+#define MYSTL_PREFETCH(addr) ((void)(addr))
+#endif
+
+// MYSTL_HAS_MMAP: files can be memory-mapped with POSIX mmap, which
+// MyFrozenHashMap::open uses to load an image without reading it. Where it
+// is 0 the image is read into memory instead.
+#ifndef MYSTL_HAS_MMAP
+#if defined(__unix__) || defined(__APPLE__)
+#define MYSTL_HAS_MMAP 1
+#else
+#define MYSTL_HAS_MMAP 0
+#endif
+#endif
+
+// MYSTL_HASHTABLE_STATS: MyHashTable counts rehashes, lookups and the
+// nodes each lookup compares, for the operation counters of stats().
+// Off by default, which removes the counters and their updates entirely.
+#ifndef MYSTL_HASHTABLE_STATS
+#define MYSTL_HASHTABLE_STATS 0
+#endif
+
 namespace mystl {
 
     inline constexpr const char* version() {
@@ -16,4 +70,4 @@ namespace mystl {
 } // namespace mystl
 
 
-#endif // MYSTL_CONFIG_H
\ No newline at end of file
+#endif // MYSTL_CONFIG_H
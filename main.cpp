@@ -1,6 +1,7 @@
 #include <iostream>
 
 #include "my_vector.h"
+#include "my_small_vector.h"
 #include "my_list.h"
 #include "my_deque.h"
 #include "my_queue.h"
@@ -12,6 +13,7 @@
 #include "my_hashtable.h"
 #include "my_unordered_set.h"
 #include "my_unordered_map.h"
+#include "my_flat_hash_map.h"
 #include "my_multiset.h"
 #include "my_multimap.h"
 #include "my_priority_queue.h"
@@ -80,6 +82,17 @@ int main() {
     std::cout << "Sorted & reversed vector: ";
     for (auto x : v) std::cout << x << " ";
     
+    std::cout << "\n ======== Test MySmallVector =============\n";
+    mystl::MySmallVector<int, 4> sv = {4, 2, 3};
+    std::cout << "Inline before growth: " << (sv.is_inline() ? "yes" : "no") << "\n";
+    sv.push_back(1);
+    sv.push_back(5);
+    std::cout << "Inline after 5 elements: " << (sv.is_inline() ? "yes" : "no") << "\n";
+    mystl::sort(sv.begin(), sv.end());
+    std::cout << "Sorted small vector: ";
+    for (auto x : sv) std::cout << x << " ";
+    std::cout << "\n";
+
     // ===================
     // Test for mylist
     // ===================
@@ -319,6 +332,19 @@ int main() {
 
     std::cout <<std::endl;
 
+    std::cout << "======== Test MyFlatHashMap =============\n";
+
+    mystl::MyFlatHashMap<std::string, int> fmap;
+    fmap["apple"] = 10;
+    fmap["banana"] = 20;
+    fmap.insert("orange", 30);
+    fmap.erase("apple");
+
+    std::cout << "banana: " << *fmap.find("banana") << ", size: " << fmap.size() << "\n";
+    std::cout << "Contains apple? " << (fmap.contains("apple") ? "Yes" : "No") << "\n";
+
+    std::cout <<std::endl;
+
     std::cout << "======== Test MyUniquePtr =============\n";
     mystl::MyUniquePtr<int> uptr1(new int(10));
     std::cout << "uptr1 value: " << *uptr1 << std::endl;